@@ -1,15 +1,13 @@
-#include <chrono>
 #include <iostream>
-#include <thread>
 
 #include <wgpu.hpp>
 
-int main()
+wgpu::Task<> run(wgpu::Executor &executor, const wgpu::Instance &instance)
 {
     // Initalize WebGPU.
-    const auto instance = wgpu::create_instance({});
-    const auto adapter = instance.create_adapter({}).value();
-    const auto device = adapter.create_device({}).value();
+    const auto adapter = (co_await instance.request_adapter(executor, {})).value();
+    const auto device = (co_await adapter.request_device(executor, {})).value();
+    executor.add_device(device);
 
     // Create data on the CPU.
     std::vector<uint8_t> data(16);
@@ -52,39 +50,32 @@ int main()
     const auto command_buffer = command_encoder.finish({.label = "Command Buffer"});
     queue.submit({command_buffer});
 
-    struct Context
+    // Suspend until the copy has finished and the buffer is mapped. The executor blocks or sleeps meanwhile.
+    const auto status = co_await output_buffer.map_async(executor, wgpu::MapModeFlags::Read, 0, 16 * sizeof(uint8_t));
+    if (status != wgpu::BufferMapAsyncStatus::Success)
     {
-        bool mapped = false;
-        wgpu::Buffer buffer;
-    };
-    Context context{.buffer = output_buffer};
+        std::cerr << "Failed to map buffer." << std::endl;
+        co_return;
+    }
 
-    const auto callback = output_buffer.map_async(wgpu::MapModeFlags::Read, 0, 16 * sizeof(uint8_t),
-        [&context](const wgpu::BufferMapAsyncStatus status)
-        {
-            if (status != wgpu::BufferMapAsyncStatus::Success)
-            {
-                std::cerr << "Failed to map buffer." << std::endl;
-                return;
-            }
+    const auto *mapped_data = output_buffer.get_const_mapped_range<uint8_t>(0, 16);
 
-            const auto *data = context.buffer.get_const_mapped_range<uint8_t>(0, 16);
+    std::cout << "GPU -> CPU: [";
+    for (int i = 0; i < 16; ++i) {
+        if (i > 0) std::cout << ", ";
+        std::cout << static_cast<int>(mapped_data[i]);
+    }
+    std::cout << "]" << std::endl;
 
-            std::cout << "GPU -> CPU: [";
-            for (int i = 0; i < 16; ++i) {
-                if (i > 0) std::cout << ", ";
-                std::cout << static_cast<int>(data[i]);
-            }
-            std::cout << "]" << std::endl;
+    output_buffer.unmap();
+}
 
-            context.buffer.unmap();
-            context.mapped = true;
-        });
+int main()
+{
+    const auto instance = wgpu::create_instance({});
 
-    while (!context.mapped)
-    {
-        device.tick();
-    }
+    wgpu::Executor executor{instance};
+    executor.run(run(executor, instance));
 
     return 0;
 }
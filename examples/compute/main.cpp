@@ -0,0 +1,139 @@
+#include <atomic>
+#include <iostream>
+
+#include <wgpu.hpp>
+
+int main()
+{
+    // Initalize WebGPU.
+    const auto instance = wgpu::create_instance({});
+    const auto adapter = instance.create_adapter({}).value();
+    const auto device = adapter.create_device({}).value();
+
+    constexpr uint32_t element_count = 64;
+    constexpr uint32_t workgroup_size = 32;
+
+    // Create data on the CPU.
+    std::vector<float> data(element_count);
+    for (uint32_t i = 0; i < element_count; ++i)
+    {
+        data[i] = static_cast<float>(i);
+    }
+
+    const auto shader_src = "@group(0) @binding(0) var<storage, read_write> values: array<f32>;\n"
+                            "\n"
+                            "@compute @workgroup_size(32)\n"
+                            "fn cs_main(@builtin(global_invocation_id) id: vec3u) {\n"
+                            "    if (id.x < arrayLength(&values)) {\n"
+                            "        values[id.x] = values[id.x] * 2.0 + 1.0;\n"
+                            "    }\n"
+                            "}\n";
+
+    constexpr wgpu::ShaderModuleWGSLDescriptor wgsl_descriptor
+    {
+        .chain = wgpu::ChainedStruct
+        {
+            .next_in_chain = nullptr,
+            .s_type = wgpu::SType::ShaderModuleWGSLDescriptor,
+        },
+        .code = shader_src
+    };
+
+    const auto shader_module = device.create_shader_module({
+        .next_in_chain = &wgsl_descriptor.chain,
+        .label = "Shader Module",
+    });
+
+    // Let the implementation derive the bind group layout from the shader.
+    const auto compute_pipeline = device.create_compute_pipeline(
+    {
+        .label = "Compute Pipeline",
+        .layout = std::nullopt,
+        .compute = wgpu::ProgrammableStageDescriptor
+        {
+            .module = shader_module,
+            .entry_point = "cs_main",
+        },
+    });
+
+    const auto storage_buffer = device.create_buffer(
+    {
+        .label = "Storage Buffer",
+        .usage = wgpu::BufferUsageFlags::Storage | wgpu::BufferUsageFlags::CopyDst | wgpu::BufferUsageFlags::CopySrc,
+        .size = element_count * sizeof(float),
+        .mapped_at_creation = false,
+    });
+
+    const auto output_buffer = device.create_buffer(
+    {
+        .label = "Output Buffer",
+        .usage = wgpu::BufferUsageFlags::CopyDst | wgpu::BufferUsageFlags::MapRead,
+        .size = element_count * sizeof(float),
+        .mapped_at_creation = false,
+    });
+
+    const auto bind_group_layout = compute_pipeline.get_bind_group_layout(0);
+    const auto bind_group = device.create_bind_group(
+    {
+        .label = "Bind Group",
+        .layout = bind_group_layout,
+        .entries =
+        {
+            {
+                .binding = 0,
+                .buffer = storage_buffer,
+                .offset = 0,
+                .size = element_count * sizeof(float),
+            },
+        },
+    });
+
+    const auto queue = device.get_queue();
+    queue.write_buffer(storage_buffer, 0, data);
+
+    // Run the shader and copy the result into a mappable buffer.
+    const auto command_encoder = device.create_command_encoder({.label = "Command Encoder"});
+
+    const auto compute_pass = command_encoder.begin_compute_pass({.label = "Compute Pass"});
+    compute_pass.set_pipeline(compute_pipeline);
+    compute_pass.set_bind_group(0, bind_group);
+    compute_pass.dispatch_workgroups((element_count + workgroup_size - 1) / workgroup_size, 1, 1);
+    compute_pass.end();
+
+    command_encoder.copy_buffer_to_buffer(storage_buffer, 0, output_buffer, 0, element_count * sizeof(float));
+
+    // Process the device's events on a background thread, so the main thread can sleep until the readback lands.
+    wgpu::EventPump event_pump{instance, device};
+
+    const auto command_buffer = command_encoder.finish({.label = "Command Buffer"});
+    queue.submit({command_buffer});
+
+    std::atomic<bool> mapped = false;
+    output_buffer.map_async(wgpu::MapModeFlags::Read, 0, element_count * sizeof(float),
+        [&mapped, &output_buffer](const wgpu::BufferMapAsyncStatus status)
+        {
+            if (status != wgpu::BufferMapAsyncStatus::Success)
+            {
+                std::cerr << "Failed to map buffer." << std::endl;
+                mapped = true;
+                return;
+            }
+
+            const auto *result = output_buffer.get_const_mapped_range<float>(0, element_count);
+
+            std::cout << "GPU -> CPU: [";
+            for (uint32_t i = 0; i < element_count; ++i) {
+                if (i > 0) std::cout << ", ";
+                std::cout << result[i];
+            }
+            std::cout << "]" << std::endl;
+
+            output_buffer.unmap();
+            mapped = true;
+        });
+    event_pump.notify();
+
+    event_pump.wait([&mapped] { return mapped.load(); });
+
+    return 0;
+}
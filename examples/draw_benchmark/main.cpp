@@ -0,0 +1,143 @@
+#include <chrono>
+#include <iostream>
+
+#include <wgpu.hpp>
+
+constexpr uint32_t DRAWS_PER_PASS = 20000;
+constexpr uint32_t PASSES = 50;
+
+// Records the same draw stream through the wrapper and through the raw C API and reports the recording cost of
+// each per draw. Both numbers should match, as the per-draw calls are defined inline in wgpu.hpp.
+int main()
+{
+    const auto instance = wgpu::create_instance({});
+    const auto adapter = instance.create_adapter({}).value();
+    const auto device = adapter.create_device({}).value();
+
+    const auto target = device.create_texture(
+    {
+        .label = "Render Target",
+        .usage = wgpu::TextureUsageFlags::RenderAttachment,
+        .dimension = wgpu::TextureDimension::_2D,
+        .size = {64, 64, 1},
+        .format = wgpu::TextureFormat::RGBA8Unorm,
+        .mip_level_count = 1,
+        .sample_count = 1,
+    });
+    const auto target_view = target.create_view();
+
+    constexpr auto shader_src = "@vertex\n"
+                                "fn vs_main(@builtin(vertex_index) in_vertex_index: u32) -> @builtin(position) vec4f {\n"
+                                "   return vec4f(f32(in_vertex_index), 0.0, 0.0, 1.0);\n"
+                                "}\n"
+                                "\n"
+                                "@fragment\n"
+                                "fn fs_main() -> @location(0) vec4f {\n"
+                                "   return vec4f(1.0, 1.0, 1.0, 1.0);\n"
+                                "}\n";
+
+    constexpr wgpu::ShaderModuleWGSLDescriptor wgsl_descriptor
+    {
+        .chain = wgpu::ChainedStruct
+        {
+            .next_in_chain = nullptr,
+            .s_type = wgpu::SType::ShaderModuleWGSLDescriptor,
+        },
+        .code = shader_src
+    };
+
+    const auto shader_module = device.create_shader_module({
+        .next_in_chain = &wgsl_descriptor.chain,
+        .label = "Shader Module",
+    });
+
+    const auto render_pipeline = device.create_render_pipeline(wgpu::RenderPipelineDescriptor
+    {
+        .label = "Render Pipeline",
+        .vertex = wgpu::VertexState
+        {
+            .module = shader_module,
+            .entry_point = "vs_main",
+        },
+        .primitive = wgpu::PrimitiveState
+        {
+            .topology = wgpu::PrimitiveTopology::TriangleList,
+            .strip_index_format = wgpu::IndexFormat::Undefined,
+            .front_face = wgpu::FrontFace::CCW,
+            .cull_mode = wgpu::CullMode::None,
+        },
+        .multisample = wgpu::MultisampleState
+        {
+            .count = 1,
+            .mask = ~0u,
+            .alpha_to_coverage_enabled = false,
+        },
+        .fragment = wgpu::FragmentState
+        {
+            .module = shader_module,
+            .entry_point = "fs_main",
+            .targets = std::vector<wgpu::ColorTargetState>
+            {
+                {
+                    .format = wgpu::TextureFormat::RGBA8Unorm,
+                    .write_mask = wgpu::ColorWriteMaskFlags::All,
+                }
+            },
+        }
+    });
+
+    const auto record = [&](const auto &record_draws)
+    {
+        std::chrono::nanoseconds elapsed{0};
+
+        for (uint32_t pass = 0; pass < PASSES; ++pass)
+        {
+            const auto command_encoder = device.create_command_encoder({.label = "Command Encoder"});
+            const auto render_pass = command_encoder.begin_render_pass({
+                .label = "Render Pass",
+                .color_attachments = std::vector<wgpu::RenderPassColorAttachment>
+                {
+                    {
+                        .view = target_view,
+                        .load_op = wgpu::LoadOp::Clear,
+                        .store_op = wgpu::StoreOp::Store,
+                        .clear_value = {0.0f, 0.0f, 0.0f, 1.0f}
+                    }
+                },
+            });
+
+            const auto start = std::chrono::steady_clock::now();
+            record_draws(render_pass);
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            render_pass.end();
+            const auto command_buffer = command_encoder.finish({.label = "Command Buffer"});
+        }
+
+        return static_cast<double>(elapsed.count()) / (PASSES * DRAWS_PER_PASS);
+    };
+
+    const auto wrapper_ns = record([&](const wgpu::RenderPassEncoder &render_pass)
+    {
+        render_pass.set_pipeline(render_pipeline);
+        for (uint32_t i = 0; i < DRAWS_PER_PASS; ++i)
+        {
+            render_pass.draw(3, 1, 0, i);
+        }
+    });
+
+    const auto c_api_ns = record([&](const wgpu::RenderPassEncoder &render_pass)
+    {
+        const auto handle = render_pass.c_ptr();
+        wgpuRenderPassEncoderSetPipeline(handle, render_pipeline.c_ptr());
+        for (uint32_t i = 0; i < DRAWS_PER_PASS; ++i)
+        {
+            wgpuRenderPassEncoderDraw(handle, 3, 1, 0, i);
+        }
+    });
+
+    std::cout << "wgpu-cpp: " << wrapper_ns << " ns/draw" << std::endl;
+    std::cout << "C API:    " << c_api_ns << " ns/draw" << std::endl;
+
+    return 0;
+}
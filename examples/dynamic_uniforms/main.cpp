@@ -1,3 +1,4 @@
+#include <array>
 #include <iostream>
 
 #include <GLFW/glfw3.h>
@@ -6,12 +7,6 @@
 
 constexpr uint32_t WINDOW_WIDTH = 600, WINDOW_HEIGHT = 400;
 
-uint32_t ceil_to_next_multiple(const uint32_t value, const uint32_t step)
-{
-    const uint32_t divide_and_ceil = value / step + (value % step == 0 ? 0 : 1);
-    return step * divide_and_ceil;
-}
-
 int main()
 {
     if (!glfwInit())
@@ -33,7 +28,6 @@ int main()
     const auto device = adapter.create_device({}).value();
     const auto queue = device.get_queue();
 
-    const auto device_limits = device.get_limits().value().limits;
     const auto surface_capabilities = surface.get_capabilities(adapter);
 
     surface.configure(
@@ -80,15 +74,8 @@ int main()
     });
     queue.write_buffer(index_buffer, 0, index_data);
 
-    const uint32_t uniform_stride = ceil_to_next_multiple(sizeof(float), device_limits.min_uniform_buffer_offset_alignment);
-
-    const auto uniform_buffer = device.create_buffer(
-    {
-        .label = "Uniform Buffer",
-        .usage = wgpu::BufferUsageFlags::CopyDst | wgpu::BufferUsageFlags::Uniform,
-        .mapped_at_creation = false,
-        .size = uniform_stride * 5 + sizeof(float), // Enough space for SIX floats.
-    });
+    // Enough space for six floats, each at the device's uniform offset alignment.
+    wgpu::UniformRing uniform_ring{device, 6 * 256};
 
     const auto bind_group_layout = device.create_bind_group_layout(
     {
@@ -116,7 +103,7 @@ int main()
         {
             {
                 .binding = 0,
-                .buffer = uniform_buffer,
+                .buffer = uniform_ring.get_buffer(),
                 .offset = 0,
                 .size = sizeof(float),
             }
@@ -168,7 +155,7 @@ int main()
     const auto pipeline_layout = device.create_pipeline_layout(
     {
         .label = "Pipeline Layout",
-        .bind_group_layouts = std::vector
+        .bind_group_layouts = std::vector<wgpu::BindGroupLayoutRef>
         {
             bind_group_layout,
         }
@@ -254,11 +241,13 @@ int main()
         device.tick();
         glfwPollEvents();
 
+        // Pack an offset time for each dynamic instance, then upload all six at once.
+        std::array<uint32_t, 6> uniform_offsets{};
         for (auto i = 0; i < 6; ++i)
         {
-            // Update the uniform buffer for each dynamic instance with an offset time.
-            queue.write_buffer(uniform_buffer, i * uniform_stride, static_cast<float>(glfwGetTime() + i));
+            uniform_offsets[i] = uniform_ring.push(static_cast<float>(glfwGetTime() + i)).value();
         }
+        uniform_ring.flush(queue);
 
         const auto command_encoder = device.create_command_encoder({.label = "Command Encoder"});
 
@@ -284,7 +273,7 @@ int main()
 
         for (auto i = 0; i < 6; ++i)
         {
-            render_pass.set_bind_group(0, bind_group, {i * uniform_stride});
+            render_pass.set_bind_group(0, bind_group, {uniform_offsets[i]});
             render_pass.draw_indexed(index_data.size(), 1, 0, 0, 0);
         }
 
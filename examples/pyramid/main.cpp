@@ -205,7 +205,7 @@ int main()
     const auto pipeline_layout = device.create_pipeline_layout(
     {
         .label = "Pipeline Layout",
-        .bind_group_layouts = std::vector
+        .bind_group_layouts = std::vector<wgpu::BindGroupLayoutRef>
         {
             bind_group_layout,
         },
@@ -292,6 +292,25 @@ int main()
         }
     });
 
+    // The scene is static, so record its draw commands once and replay them every frame.
+    const auto render_bundle_encoder = device.create_render_bundle_encoder(
+    {
+        .label = "Render Bundle Encoder",
+        .color_formats = {surface.get_capabilities(adapter).formats[0]},
+        .depth_stencil_format = depth_texture.get_format(),
+        .sample_count = 1,
+        .depth_read_only = false,
+        .stencil_read_only = true,
+    });
+
+    render_bundle_encoder.set_pipeline(render_pipeline);
+    render_bundle_encoder.set_vertex_buffer(0, point_buffer, 0, point_buffer.get_size());
+    render_bundle_encoder.set_index_buffer(index_buffer, wgpu::IndexFormat::Uint16, 0, index_buffer.get_size());
+    render_bundle_encoder.set_bind_group(0, bind_group);
+    render_bundle_encoder.draw_indexed(index_data.size(), 1, 0, 0, 0);
+
+    const auto render_bundle = render_bundle_encoder.finish({.label = "Render Bundle"});
+
     while (!glfwWindowShouldClose(window))
     {
         instance.process_events();
@@ -338,11 +357,7 @@ int main()
             },
         });
 
-        render_pass.set_pipeline(render_pipeline);
-        render_pass.set_vertex_buffer(0, point_buffer, 0, point_buffer.get_size());
-        render_pass.set_index_buffer(index_buffer, wgpu::IndexFormat::Uint16, 0, index_buffer.get_size());
-        render_pass.set_bind_group(0, bind_group);
-        render_pass.draw_indexed(index_data.size(), 1, 0, 0, 0);
+        render_pass.execute_bundles({render_bundle});
 
         render_pass.end();
         const auto command_buffer = command_encoder.finish({.label = "Command Buffer"});
@@ -240,7 +240,7 @@ int main()
         wgpu::PipelineLayoutDescriptor
         {
             .label = "Pipeline Layout",
-            .bind_group_layouts = std::vector
+            .bind_group_layouts = std::vector<wgpu::BindGroupLayoutRef>
             {
                 bind_group_layout,
             },
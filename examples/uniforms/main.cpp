@@ -159,7 +159,7 @@ int main()
     const auto pipeline_layout = device.create_pipeline_layout(
     {
         .label = "Pipeline Layout",
-        .bind_group_layouts = std::vector
+        .bind_group_layouts = std::vector<wgpu::BindGroupLayoutRef>
         {
             bind_group_layout,
         }
@@ -1,6 +1,14 @@
 #include "wgpu.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <deque>
 #include <iostream>
+#include <thread>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#endif
 
 namespace wgpu
 {
@@ -139,2031 +147,3861 @@ namespace wgpu
         return static_cast<uint32_t>(lhs) == static_cast<uint32_t>(rhs);
     }
 
-    Adapter::Adapter(const WGPUAdapter &handle) : m_handle(handle)
-    {
-
-    }
-
-    Adapter::~Adapter()
-    {
-        if (m_handle != nullptr)
-        {
-            wgpuAdapterRelease(m_handle);
-        }
-    }
-
-    Adapter::Adapter(const Adapter &other) : m_handle(other.m_handle)
-    {
-        if (m_handle != nullptr)
-        {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuAdapterReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuAdapterAddRef(m_handle);
-#endif
-        }
-    }
-
-    Adapter::Adapter(Adapter &&other) noexcept
-    {
-        std::swap(m_handle, other.m_handle);
-    }
-
-    Adapter & Adapter::operator=(const Adapter &other)
+    namespace
     {
-        if (this != &other)
+        std::span<WGPUConstantEntry> translate_constants(const std::vector<ConstantEntry> &constants,
+            FrameArena &arena)
         {
-            if (m_handle != nullptr)
-            {
-                wgpuAdapterRelease(m_handle);
-            }
-
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+            const auto wgpu_constants = arena.allocate<WGPUConstantEntry>(constants.size());
+            for (size_t i = 0; i < constants.size(); ++i)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuAdapterReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuAdapterAddRef(m_handle);
-#endif
+                wgpu_constants[i] = WGPUConstantEntry
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(constants[i].next_in_chain),
+                    .key = constants[i].key.c_str(),
+                    .value = constants[i].value,
+                };
             }
+            return wgpu_constants;
         }
-        return *this;
-    }
 
-    Adapter & Adapter::operator=(Adapter &&other) noexcept
-    {
-        if (this != &other)
+        // Every pointer in the returned descriptor points either into the arena or into the given descriptor.
+        WGPURenderPipelineDescriptor translate_render_pipeline_descriptor(const RenderPipelineDescriptor &descriptor,
+            FrameArena &arena)
         {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
-    }
+            const auto wgpu_vertex_constants = translate_constants(descriptor.vertex.constants, arena);
 
-    WGPUAdapter Adapter::c_ptr() const
-    {
-        return m_handle;
-    }
+            const auto wgpu_vertex_buffers = arena.allocate<WGPUVertexBufferLayout>(descriptor.vertex.buffers.size());
+            for (size_t i = 0; i < descriptor.vertex.buffers.size(); ++i)
+            {
+                const auto &buffer = descriptor.vertex.buffers[i];
 
-    std::expected<Device, std::string> Adapter::create_device(const DeviceDescriptor &descriptor) const
-    {
-        std::expected<Device, std::string> result = std::unexpected("Request did not end.");
-        bool request_ended = false;
+                const auto wgpu_attributes = arena.allocate<WGPUVertexAttribute>(buffer.attributes.size());
+                for (size_t j = 0; j < buffer.attributes.size(); ++j)
+                {
+                    wgpu_attributes[j] = WGPUVertexAttribute
+                    {
+                        .format = static_cast<WGPUVertexFormat>(buffer.attributes[j].format),
+                        .offset = buffer.attributes[j].offset,
+                        .shaderLocation = buffer.attributes[j].shader_location,
+                    };
+                }
 
-        auto on_device_request_ended = [&result, &request_ended](const RequestDeviceStatus status,
-            const Device& device, const std::string &message)
-        {
-            if (status == RequestDeviceStatus::Success)
-            {
-                result = device;
+                wgpu_vertex_buffers[i] = WGPUVertexBufferLayout
+                {
+                    .arrayStride = buffer.array_stride,
+                    .stepMode = static_cast<WGPUVertexStepMode>(buffer.step_mode),
+                    .attributeCount = wgpu_attributes.size(),
+                    .attributes = wgpu_attributes.data(),
+                };
             }
-            else
+
+            WGPUDepthStencilState *wgpu_depth_stencil = nullptr;
+            if (descriptor.depth_stencil)
             {
-                result = std::unexpected(message);
+                wgpu_depth_stencil = arena.allocate<WGPUDepthStencilState>(1).data();
+                *wgpu_depth_stencil = WGPUDepthStencilState
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.depth_stencil->next_in_chain),
+                    .format = static_cast<WGPUTextureFormat>(descriptor.depth_stencil->format),
+                    .depthWriteEnabled = descriptor.depth_stencil->depth_write_enabled,
+                    .depthCompare = static_cast<WGPUCompareFunction>(descriptor.depth_stencil->depth_compare),
+                    .stencilFront = WGPUStencilFaceState
+                    {
+                        .compare = static_cast<WGPUCompareFunction>(descriptor.depth_stencil->stencil_front.compare),
+                        .failOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_front.fail_op),
+                        .depthFailOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_front.depth_fail_op),
+                        .passOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_front.pass_op),
+                    },
+                    .stencilBack = WGPUStencilFaceState
+                    {
+                        .compare = static_cast<WGPUCompareFunction>(descriptor.depth_stencil->stencil_back.compare),
+                        .failOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_back.fail_op),
+                        .depthFailOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_back.depth_fail_op),
+                        .passOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_back.pass_op),
+                    },
+                    .stencilReadMask = descriptor.depth_stencil->stencil_read_mask,
+                    .stencilWriteMask = descriptor.depth_stencil->stencil_write_mask,
+                    .depthBias = descriptor.depth_stencil->depth_bias,
+                    .depthBiasSlopeScale = descriptor.depth_stencil->depth_bias_slope_scale,
+                    .depthBiasClamp = descriptor.depth_stencil->depth_bias_clamp,
+                };
             }
-            request_ended = true;
-        };
-
-        auto handle = request_device(descriptor, on_device_request_ended);
-
-        // TODO: emscripten_sleep
 
-        return result;
-    }
-
-    std::vector<FeatureName> Adapter::enumerate_features() const
-    {
-        const auto feature_count = wgpuAdapterEnumerateFeatures(m_handle, nullptr);
+            WGPUFragmentState *wgpu_fragment = nullptr;
+            if (descriptor.fragment)
+            {
+                const auto wgpu_fragment_constants = translate_constants(descriptor.fragment->constants, arena);
 
-        std::vector<FeatureName> features(feature_count);
-        wgpuAdapterEnumerateFeatures(m_handle, reinterpret_cast<WGPUFeatureName*>(features.data()));
+                const auto &targets = descriptor.fragment->targets;
+                const auto wgpu_fragment_targets = arena.allocate<WGPUColorTargetState>(targets.size());
+                for (size_t i = 0; i < targets.size(); ++i)
+                {
+                    const auto &target = targets[i];
 
-        return features;
-    }
+                    WGPUBlendState *wgpu_blend = nullptr;
+                    if (target.blend)
+                    {
+                        wgpu_blend = arena.allocate<WGPUBlendState>(1).data();
+                        *wgpu_blend = WGPUBlendState
+                        {
+                            .color = WGPUBlendComponent
+                            {
+                                .operation = static_cast<WGPUBlendOperation>(target.blend->color.operation),
+                                .srcFactor = static_cast<WGPUBlendFactor>(target.blend->color.src_factor),
+                                .dstFactor = static_cast<WGPUBlendFactor>(target.blend->color.dst_factor),
+                            },
+                            .alpha = WGPUBlendComponent
+                            {
+                                .operation = static_cast<WGPUBlendOperation>(target.blend->alpha.operation),
+                                .srcFactor = static_cast<WGPUBlendFactor>(target.blend->alpha.src_factor),
+                                .dstFactor = static_cast<WGPUBlendFactor>(target.blend->alpha.dst_factor),
+                            }
+                        };
+                    }
+
+                    wgpu_fragment_targets[i] = WGPUColorTargetState
+                    {
+                        .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(target.next_in_chain),
+                        .format = static_cast<WGPUTextureFormat>(target.format),
+                        .blend = wgpu_blend,
+                        .writeMask = static_cast<WGPUColorWriteMaskFlags>(target.write_mask),
+                    };
+                }
 
-    std::optional<SupportedLimits> Adapter::get_limits() const
-    {
-        WGPUSupportedLimits wgpu_supported_limits{};
-        const auto result = wgpuAdapterGetLimits(m_handle, &wgpu_supported_limits);
+                wgpu_fragment = arena.allocate<WGPUFragmentState>(1).data();
+                *wgpu_fragment = WGPUFragmentState
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.fragment->next_in_chain),
+                    .module = descriptor.fragment->module.c_ptr(),
+                    .entryPoint = descriptor.fragment->entry_point ? descriptor.fragment->entry_point->c_str() : nullptr,
+                    .constantCount = wgpu_fragment_constants.size(),
+                    .constants = wgpu_fragment_constants.data(),
+                    .targetCount = wgpu_fragment_targets.size(),
+                    .targets = wgpu_fragment_targets.data(),
+                };
+            }
 
-#ifdef WEBGPU_BACKEND_WGPU
-        if (!result)
-#endif
-#ifdef WEBGPU_BACKEND_DAWN
-        if (result != WGPUStatus_Success)
-#endif
-        {
-            return std::nullopt;
+            return WGPURenderPipelineDescriptor
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+                .label = descriptor.label.c_str(),
+                .layout = descriptor.layout.c_ptr(),
+                .vertex = WGPUVertexState
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.vertex.next_in_chain),
+                    .module = descriptor.vertex.module.c_ptr(),
+                    .entryPoint = descriptor.vertex.entry_point ? descriptor.vertex.entry_point->c_str() : nullptr,
+                    .constantCount = wgpu_vertex_constants.size(),
+                    .constants = wgpu_vertex_constants.data(),
+                    .bufferCount = wgpu_vertex_buffers.size(),
+                    .buffers = wgpu_vertex_buffers.data(),
+                },
+                .primitive = WGPUPrimitiveState
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.primitive.next_in_chain),
+                    .topology = static_cast<WGPUPrimitiveTopology>(descriptor.primitive.topology),
+                    .stripIndexFormat = static_cast<WGPUIndexFormat>(descriptor.primitive.strip_index_format),
+                    .frontFace = static_cast<WGPUFrontFace>(descriptor.primitive.front_face),
+                    .cullMode = static_cast<WGPUCullMode>(descriptor.primitive.cull_mode),
+                },
+                .depthStencil = wgpu_depth_stencil,
+                .multisample = WGPUMultisampleState
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.multisample.next_in_chain),
+                    .count = descriptor.multisample.count,
+                    .mask = descriptor.multisample.mask,
+                    .alphaToCoverageEnabled = descriptor.multisample.alpha_to_coverage_enabled,
+                },
+                .fragment = wgpu_fragment,
+            };
         }
 
-        return *reinterpret_cast<SupportedLimits *>(&wgpu_supported_limits);
-    }
-
-    std::optional<AdapterProperties> Adapter::get_properties() const
-    {
-        WGPUAdapterProperties wgpu_properties{};
-#ifdef WEBGPU_BACKEND_WGPU
-        wgpuAdapterGetProperties(m_handle, &wgpu_properties);
-#endif
-#ifdef WEBGPU_BACKEND_DAWN
-        if (wgpuAdapterGetProperties(m_handle, &wgpu_properties) != WGPUStatus_Success)
+        // Copies a borrowed label into storage and points the label at the copy.
+        void own_label(Label &label, std::string &storage)
         {
-            return std::nullopt;
+            if (const char *source = label.c_str())
+            {
+                storage = source;
+                label = storage;
+            }
         }
-#endif
-
-        return AdapterProperties{
-            .next_in_chain = reinterpret_cast<ChainedStructOut *>(wgpu_properties.nextInChain),
-            .vendor_id = wgpu_properties.vendorID,
-            .vendor_name = wgpu_properties.vendorName,
-            .architecture = wgpu_properties.architecture,
-            .device_id = wgpu_properties.deviceID,
-            .name = wgpu_properties.name,
-            .driver_description = wgpu_properties.driverDescription,
-            .adapter_type = static_cast<AdapterType>(wgpu_properties.adapterType),
-            .backend_type = static_cast<BackendType>(wgpu_properties.backendType),
-        };
-    }
-
-    bool Adapter::has_feature(const FeatureName feature) const
-    {
-        return wgpuAdapterHasFeature(m_handle, static_cast<WGPUFeatureName>(feature));
-    }
-
-    std::unique_ptr<RequestDeviceCallback> Adapter::request_device(const DeviceDescriptor &descriptor,
-        RequestDeviceCallback &&callback) const
-    {
-        auto handle = std::make_unique<RequestDeviceCallback>(callback);
-        static auto on_request_ended = [](WGPURequestDeviceStatus status, WGPUDevice device,
-            const char *message, void *user_data) -> void
-        {
-            const RequestDeviceCallback& callback = *static_cast<RequestDeviceCallback*>(user_data);
-            callback(static_cast<RequestDeviceStatus>(status), Device{device}, message ? message : "");
-        };
 
-        // TODO: Allow user to set uncaptured error callback
-#ifdef WEBGPU_BACKEND_DAWN
-        static auto on_uncaptured_error = [](WGPUErrorType type, const char *message, void *user_data) -> void
+        // Takes a reference on a borrowed handle, so the result keeps it alive on its own.
+        template<typename T, typename C>
+        T retain(const HandleRef<T, C> &ref)
         {
-            std::cerr << "Uncaptured error: " << message << std::endl;
-        };
-#endif
-
-        const WGPUDeviceDescriptor wgpu_descriptor = {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .requiredFeatureCount = descriptor.required_features.size(),
-            .requiredFeatures = reinterpret_cast<const WGPUFeatureName *>(descriptor.required_features.data()),
-            .requiredLimits = reinterpret_cast<const WGPURequiredLimits *>(descriptor.required_limits),
-            .defaultQueue = {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.default_queue.next_in_chain),
-                .label = descriptor.default_queue.label.c_str()
-            },
-            .deviceLostCallback = nullptr,
-            .deviceLostUserdata = nullptr,
-#ifdef WEBGPU_BACKEND_DAWN
-            .deviceLostCallbackInfo = {},
-            .uncapturedErrorCallbackInfo = {
-                .callback = on_uncaptured_error,
-            },
-#endif
-        };
-
-        wgpuAdapterRequestDevice(m_handle, &wgpu_descriptor, on_request_ended, handle.get());
-        return handle;
-    }
-
-    BindGroup::BindGroup(const WGPUBindGroup &handle) : m_handle(handle)
-    {
-
-    }
+            if (ref)
+            {
+                HandleTraits<C>::add_ref(ref.c_ptr());
+            }
+            return T{ref.c_ptr()};
+        }
 
-    BindGroup::~BindGroup()
-    {
-        if (m_handle != nullptr)
+        template<typename T>
+        void append_key(std::string &key, const T &value)
         {
-            wgpuBindGroupRelease(m_handle);
+            static_assert(std::is_trivially_copyable_v<T>);
+            key.append(reinterpret_cast<const char *>(&value), sizeof(T));
         }
-    }
 
-    BindGroup::BindGroup(const BindGroup &other) : m_handle(other.m_handle)
-    {
-        if (m_handle != nullptr)
+        void append_key(std::string &key, const std::string &value)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuBindGroupReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuBindGroupAddRef(m_handle);
-#endif
+            append_key(key, value.size());
+            key.append(value);
         }
-    }
 
-    BindGroup::BindGroup(BindGroup &&other) noexcept
-    {
-        std::swap(m_handle, other.m_handle);
-    }
-
-    BindGroup & BindGroup::operator=(const BindGroup &other)
-    {
-        if (this != &other)
+        void append_key(std::string &key, const std::optional<std::string> &value)
         {
-            if (m_handle != nullptr)
+            append_key(key, value.has_value());
+            if (value)
             {
-                wgpuBindGroupRelease(m_handle);
+                append_key(key, *value);
             }
+        }
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+        void append_key(std::string &key, const std::vector<ConstantEntry> &constants)
+        {
+            append_key(key, constants.size());
+            for (const auto &constant : constants)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuBindGroupReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuBindGroupAddRef(m_handle);
-#endif
+                append_key(key, constant.next_in_chain);
+                append_key(key, constant.key);
+                append_key(key, constant.value);
             }
         }
-        return *this;
-    }
 
-    BindGroup & BindGroup::operator=(BindGroup &&other) noexcept
-    {
-        if (this != &other)
+        void append_key(std::string &key, const BlendComponent &component)
         {
-            std::swap(m_handle, other.m_handle);
+            append_key(key, component.operation);
+            append_key(key, component.src_factor);
+            append_key(key, component.dst_factor);
         }
-        return *this;
-    }
-
-    WGPUBindGroup BindGroup::c_ptr() const
-    {
-        return m_handle;
-    }
-
-    BindGroupLayout::BindGroupLayout(const WGPUBindGroupLayout &handle) : m_handle(handle)
-    {
 
-    }
-
-    BindGroupLayout::~BindGroupLayout()
-    {
-        if (m_handle != nullptr)
+        void append_key(std::string &key, const StencilFaceState &state)
         {
-            wgpuBindGroupLayoutRelease(m_handle);
+            append_key(key, state.compare);
+            append_key(key, state.fail_op);
+            append_key(key, state.depth_fail_op);
+            append_key(key, state.pass_op);
         }
-    }
 
-    BindGroupLayout::BindGroupLayout(const BindGroupLayout &other) : m_handle(other.m_handle)
-    {
-        if (m_handle != nullptr)
+        // Writes every field of the descriptor except the label into key. Counts and optional flags are written
+        // too, so two different descriptors can never produce the same bytes.
+        void append_key(std::string &key, const RenderPipelineDescriptor &descriptor)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuBindGroupLayoutReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuBindGroupLayoutAddRef(m_handle);
-#endif
-        }
-    }
+            append_key(key, descriptor.next_in_chain);
+            append_key(key, descriptor.layout.c_ptr());
 
-    BindGroupLayout::BindGroupLayout(BindGroupLayout &&other) noexcept
-    {
-        std::swap(m_handle, other.m_handle);
-    }
+            const auto &vertex = descriptor.vertex;
+            append_key(key, vertex.next_in_chain);
+            append_key(key, vertex.module.c_ptr());
+            append_key(key, vertex.entry_point);
+            append_key(key, vertex.constants);
+            append_key(key, vertex.buffers.size());
+            for (const auto &buffer : vertex.buffers)
+            {
+                append_key(key, buffer.array_stride);
+                append_key(key, buffer.step_mode);
+                append_key(key, buffer.attributes.size());
+                for (const auto &attribute : buffer.attributes)
+                {
+                    append_key(key, attribute.format);
+                    append_key(key, attribute.offset);
+                    append_key(key, attribute.shader_location);
+                }
+            }
 
-    BindGroupLayout & BindGroupLayout::operator=(const BindGroupLayout &other)
-    {
-        if (this != &other)
-        {
-            if (m_handle != nullptr)
+            const auto &primitive = descriptor.primitive;
+            append_key(key, primitive.next_in_chain);
+            append_key(key, primitive.topology);
+            append_key(key, primitive.strip_index_format);
+            append_key(key, primitive.front_face);
+            append_key(key, primitive.cull_mode);
+
+            append_key(key, descriptor.depth_stencil.has_value());
+            if (const auto &depth_stencil = descriptor.depth_stencil)
             {
-                wgpuBindGroupLayoutRelease(m_handle);
+                append_key(key, depth_stencil->next_in_chain);
+                append_key(key, depth_stencil->format);
+                append_key(key, depth_stencil->depth_write_enabled);
+                append_key(key, depth_stencil->depth_compare);
+                append_key(key, depth_stencil->stencil_front);
+                append_key(key, depth_stencil->stencil_back);
+                append_key(key, depth_stencil->stencil_read_mask);
+                append_key(key, depth_stencil->stencil_write_mask);
+                append_key(key, depth_stencil->depth_bias);
+                append_key(key, depth_stencil->depth_bias_slope_scale);
+                append_key(key, depth_stencil->depth_bias_clamp);
             }
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+            const auto &multisample = descriptor.multisample;
+            append_key(key, multisample.next_in_chain);
+            append_key(key, multisample.count);
+            append_key(key, multisample.mask);
+            append_key(key, multisample.alpha_to_coverage_enabled);
+
+            append_key(key, descriptor.fragment.has_value());
+            if (const auto &fragment = descriptor.fragment)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuBindGroupLayoutReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuBindGroupLayoutAddRef(m_handle);
-#endif
+                append_key(key, fragment->next_in_chain);
+                append_key(key, fragment->module.c_ptr());
+                append_key(key, fragment->entry_point);
+                append_key(key, fragment->constants);
+                append_key(key, fragment->targets.size());
+                for (const auto &target : fragment->targets)
+                {
+                    append_key(key, target.next_in_chain);
+                    append_key(key, target.format);
+                    append_key(key, target.blend.has_value());
+                    if (target.blend)
+                    {
+                        append_key(key, target.blend->color);
+                        append_key(key, target.blend->alpha);
+                    }
+                    append_key(key, target.write_mask);
+                }
             }
         }
-        return *this;
-    }
 
-    BindGroupLayout & BindGroupLayout::operator=(BindGroupLayout &&other) noexcept
-    {
-        if (this != &other)
+        // Everything an asynchronous pipeline creation reads until its callback fires: a copy of the descriptor and
+        // its label, references on the borrowed layout and shader modules, and an arena holding the translated
+        // structs that point into the copy. Chained structs are still borrowed.
+        struct PendingRenderPipeline
         {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
-    }
-
-    WGPUBindGroupLayout BindGroupLayout::c_ptr() const
-    {
-        return m_handle;
-    }
-
-    Buffer::Buffer(const WGPUBuffer &handle) : m_handle(handle)
-
-    {
+            PendingRenderPipeline(const Device &device, const RenderPipelineDescriptor &source,
+                CreateRenderPipelineCallback &&callback)
+                : device(device), descriptor(source), layout(retain(source.layout)),
+                  vertex_module(retain(source.vertex.module)),
+                  fragment_module(source.fragment ? retain(source.fragment->module) : ShaderModule{}),
+                  callback(std::move(callback))
+            {
+                own_label(descriptor.label, label);
+                wgpu_descriptor = translate_render_pipeline_descriptor(descriptor, arena);
+            }
 
-    }
+            Device device;
+            std::string label;
+            RenderPipelineDescriptor descriptor;
+            PipelineLayout layout;
+            ShaderModule vertex_module;
+            ShaderModule fragment_module;
+            FrameArena arena{4 * 1024};
+            WGPURenderPipelineDescriptor wgpu_descriptor;
+            CreateRenderPipelineCallback callback;
+        };
 
-    Buffer::~Buffer()
-    {
-        if (m_handle != nullptr)
+#ifdef WEBGPU_BACKEND_WGPU
+        // wgpu-native keeps one error scope stack per device, shared by every thread, and the library pushes scopes
+        // of its own from other threads to capture pipeline creation errors. Every push and pop, the library's and
+        // the application's, takes this lock, and the library holds it from pushing its scope to popping it, so
+        // scopes always nest. It is recursive because wgpu-native runs pop callbacks inside the pop.
+        std::recursive_mutex & get_error_scope_mutex()
         {
-            wgpuBufferRelease(m_handle);
+            static std::recursive_mutex mutex;
+            return mutex;
         }
-    }
 
-    Buffer::Buffer(const Buffer &other) : m_handle(other.m_handle)
-    {
-        if (m_handle != nullptr)
+        // Runs create inside a validation error scope and returns the message of the first error it raised, if
+        // any. wgpu-native pops scopes synchronously.
+        template<typename Create>
+        std::optional<std::string> capture_validation_error(const Device &device, Create &&create)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuBufferReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuBufferAddRef(m_handle);
-#endif
-        }
-    }
-
-    Buffer::Buffer(Buffer &&other) noexcept
-    {
-        std::swap(m_handle, other.m_handle);
-    }
+            struct ScopeResult
+            {
+                WGPUErrorType type{WGPUErrorType_NoError};
+                std::string message;
+            };
 
-    Buffer & Buffer::operator=(const Buffer &other)
-    {
-        if (this != &other)
-        {
-            if (m_handle != nullptr)
+            static auto on_error_scope_popped = [](const WGPUErrorType type, const char *message,
+                void *user_data) -> void
             {
-                wgpuBufferRelease(m_handle);
-            }
+                auto &result = *static_cast<ScopeResult *>(user_data);
+                result.type = type;
+                result.message = message ? message : "";
+            };
+
+            const std::lock_guard lock{get_error_scope_mutex()};
+            device.push_error_scope(ErrorFilter::Validation);
+            create();
+            ScopeResult result;
+            wgpuDevicePopErrorScope(device.c_ptr(), on_error_scope_popped, &result);
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+            if (result.type != WGPUErrorType_NoError)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuBufferReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuBufferAddRef(m_handle);
-#endif
+                return std::move(result.message);
             }
+            return std::nullopt;
         }
-        return *this;
-    }
 
-    Buffer & Buffer::operator=(Buffer &&other) noexcept
-    {
-        if (this != &other)
+        // wgpu-native has no asynchronous pipeline creation, so a single library-owned worker creates pipelines in
+        // the order they were requested. It is joined at exit once everything queued has been created.
+        class RenderPipelineCompileQueue
         {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
-    }
+        public:
+            [[nodiscard]] static RenderPipelineCompileQueue & get()
+            {
+                static RenderPipelineCompileQueue queue;
+                return queue;
+            }
 
-    WGPUBuffer Buffer::c_ptr() const
-    {
-        return m_handle;
-    }
+            RenderPipelineCompileQueue(const RenderPipelineCompileQueue &other) = delete;
+            RenderPipelineCompileQueue & operator=(const RenderPipelineCompileQueue &other) = delete;
 
-    const void * Buffer::get_const_mapped_range(const size_t offset, const size_t size) const
-    {
-        return wgpuBufferGetConstMappedRange(m_handle, offset, size);
-    }
+            ~RenderPipelineCompileQueue()
+            {
+                {
+                    const std::lock_guard lock{m_mutex};
+                    m_stop_requested = true;
+                }
+                m_condition.notify_one();
+                m_worker.join();
+            }
 
-    uint64_t Buffer::get_size() const
-    {
-        return wgpuBufferGetSize(m_handle);
-    }
+            void push(std::unique_ptr<PendingRenderPipeline> &&pending)
+            {
+                {
+                    const std::lock_guard lock{m_mutex};
+                    m_queue.push_back(std::move(pending));
+                }
+                m_condition.notify_one();
+            }
 
-    std::unique_ptr<MapBufferCallback> Buffer::map_async(const MapModeFlags mode, const size_t offset,
-        const size_t size, MapBufferCallback &&callback) const
-    {
-        auto handle = std::make_unique<MapBufferCallback>(callback);
+        private:
+            RenderPipelineCompileQueue() : m_worker([this] { run_worker(); })
+            {
+            }
 
+            // A descriptor that fails validation is reported to its callback instead of as an uncaptured error.
+            static void create(PendingRenderPipeline &pending)
+            {
+                RenderPipeline pipeline;
+                const auto error = capture_validation_error(pending.device, [&pending, &pipeline]
+                {
+                    pipeline = RenderPipeline{wgpuDeviceCreateRenderPipeline(pending.device.c_ptr(),
+                        &pending.wgpu_descriptor)};
+                });
+
+                if (error)
+                {
+                    pending.callback(CreatePipelineAsyncStatus::ValidationError, RenderPipeline{}, *error);
+                    return;
+                }
+                pending.callback(CreatePipelineAsyncStatus::Success, pipeline, "");
+            }
+
+            void run_worker()
+            {
+                while (true)
+                {
+                    std::unique_ptr<PendingRenderPipeline> pending;
+                    {
+                        std::unique_lock lock{m_mutex};
+                        m_condition.wait(lock, [this] { return m_stop_requested || !m_queue.empty(); });
+
+                        if (m_queue.empty())
+                        {
+                            return;
+                        }
+                        pending = std::move(m_queue.front());
+                        m_queue.pop_front();
+                    }
+
+                    create(*pending);
+                }
+            }
+
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::deque<std::unique_ptr<PendingRenderPipeline>> m_queue;
+            bool m_stop_requested{false};
+            std::thread m_worker;
+        };
+#endif
+
+        // A reference inside a descriptor copied by a ResourceRegistry, which only accepts references to its own
+        // resources. refresh points the reference at the target's current object, and the record keeps the target
+        // registered.
+        template<typename T, typename C>
+        struct TrackedReference
+        {
+            void refresh(HandleRef<T, C> &reference) const
+            {
+                if (record)
+                {
+                    reference = HandleRef<T, C>{static_cast<C>(const_cast<void *>(record->get_c_handle()))};
+                }
+            }
+
+            std::shared_ptr<detail::TrackedRecord> record;
+        };
+
+        template<typename T, typename Descriptor>
+        struct DescriptorRecord : detail::TrackedRecord
+        {
+            explicit DescriptorRecord(const Descriptor &source) : descriptor(source)
+            {
+                own_label(descriptor.label, label);
+            }
+
+            [[nodiscard]] const void * get_c_handle() const override
+            {
+                return handle.c_ptr();
+            }
+
+            T handle;
+            std::string label;
+            Descriptor descriptor;
+        };
+
+        template<typename T, typename Descriptor, T (Device::*create)(const Descriptor &) const>
+        struct IndependentRecord final : DescriptorRecord<T, Descriptor>
+        {
+            using DescriptorRecord<T, Descriptor>::DescriptorRecord;
+
+            void recreate(const Device &device) override
+            {
+                this->handle = (device.*create)(this->descriptor);
+            }
+        };
+
+        using BindGroupLayoutRecord = IndependentRecord<BindGroupLayout, BindGroupLayoutDescriptor,
+            &Device::create_bind_group_layout>;
+        using BufferRecord = IndependentRecord<Buffer, BufferDescriptor, &Device::create_buffer>;
+        using SamplerRecord = IndependentRecord<Sampler, SamplerDescriptor, &Device::create_sampler>;
+        using TextureRecord = IndependentRecord<Texture, TextureDescriptor, &Device::create_texture>;
+
+        struct ShaderModuleRecord final : DescriptorRecord<ShaderModule, ShaderModuleDescriptor>
+        {
+            explicit ShaderModuleRecord(const ShaderModuleDescriptor &source) : DescriptorRecord(source)
+            {
+                // Shader source is usually built just for the call, so it is the one chained struct copied.
+                const auto *chain = source.next_in_chain;
+                if (chain && chain->s_type == SType::ShaderModuleWGSLDescriptor)
+                {
+                    const auto &wgsl = *reinterpret_cast<const ShaderModuleWGSLDescriptor *>(chain);
+                    wgsl_code = wgsl.code;
+                    wgsl_descriptor = ShaderModuleWGSLDescriptor{.chain = wgsl.chain, .code = wgsl_code.c_str()};
+                    descriptor.next_in_chain = &wgsl_descriptor.chain;
+                }
+                else if (chain && chain->s_type == SType::ShaderModuleSPIRVDescriptor)
+                {
+                    const auto &spirv = *reinterpret_cast<const ShaderModuleSPIRVDescriptor *>(chain);
+                    spirv_code.assign(spirv.code, spirv.code + spirv.code_size);
+                    spirv_descriptor = ShaderModuleSPIRVDescriptor
+                    {
+                        .chain = spirv.chain,
+                        .code_size = spirv.code_size,
+                        .code = spirv_code.data(),
+                    };
+                    descriptor.next_in_chain = &spirv_descriptor.chain;
+                }
+            }
+
+            void recreate(const Device &device) override
+            {
+                handle = device.create_shader_module(descriptor);
+            }
+
+            std::string wgsl_code;
+            ShaderModuleWGSLDescriptor wgsl_descriptor{};
+            std::vector<uint32_t> spirv_code;
+            ShaderModuleSPIRVDescriptor spirv_descriptor{};
+        };
+
+        struct TextureViewRecord final : detail::TrackedRecord
+        {
+            [[nodiscard]] const void * get_c_handle() const override
+            {
+                return handle.c_ptr();
+            }
+
+            void recreate(const Device &) override
+            {
+                const auto &texture_handle = static_cast<const TextureRecord &>(*texture).handle;
+                handle = descriptor ? texture_handle.create_view(*descriptor) : texture_handle.create_view();
+            }
+
+            TextureView handle;
+            std::shared_ptr<detail::TrackedRecord> texture;
+            std::string label;
+            std::optional<TextureViewDescriptor> descriptor;
+        };
+
+        struct PipelineLayoutRecord final : DescriptorRecord<PipelineLayout, PipelineLayoutDescriptor>
+        {
+            using DescriptorRecord::DescriptorRecord;
+
+            void recreate(const Device &device) override
+            {
+                for (size_t i = 0; i < bind_group_layouts.size(); ++i)
+                {
+                    bind_group_layouts[i].refresh(descriptor.bind_group_layouts[i]);
+                }
+                handle = device.create_pipeline_layout(descriptor);
+            }
+
+            std::vector<TrackedReference<BindGroupLayout, WGPUBindGroupLayout>> bind_group_layouts;
+        };
+
+        struct ComputePipelineRecord final : DescriptorRecord<ComputePipeline, ComputePipelineDescriptor>
+        {
+            using DescriptorRecord::DescriptorRecord;
+
+            void recreate(const Device &device) override
+            {
+                layout.refresh(descriptor.layout);
+                module.refresh(descriptor.compute.module);
+                handle = device.create_compute_pipeline(descriptor);
+            }
+
+            TrackedReference<PipelineLayout, WGPUPipelineLayout> layout;
+            TrackedReference<ShaderModule, WGPUShaderModule> module;
+        };
+
+        struct RenderPipelineRecord final : DescriptorRecord<RenderPipeline, RenderPipelineDescriptor>
+        {
+            using DescriptorRecord::DescriptorRecord;
+
+            void recreate(const Device &device) override
+            {
+                layout.refresh(descriptor.layout);
+                vertex_module.refresh(descriptor.vertex.module);
+                if (descriptor.fragment)
+                {
+                    fragment_module.refresh(descriptor.fragment->module);
+                }
+                handle = device.create_render_pipeline(descriptor);
+            }
+
+            TrackedReference<PipelineLayout, WGPUPipelineLayout> layout;
+            TrackedReference<ShaderModule, WGPUShaderModule> vertex_module;
+            TrackedReference<ShaderModule, WGPUShaderModule> fragment_module;
+        };
+
+        struct BindGroupRecord final : DescriptorRecord<BindGroup, BindGroupDescriptor>
+        {
+            struct EntryReferences
+            {
+                TrackedReference<Buffer, WGPUBuffer> buffer;
+                TrackedReference<Sampler, WGPUSampler> sampler;
+                TrackedReference<TextureView, WGPUTextureView> texture_view;
+            };
+
+            using DescriptorRecord::DescriptorRecord;
+
+            void recreate(const Device &device) override
+            {
+                layout.refresh(descriptor.layout);
+                for (size_t i = 0; i < entries.size(); ++i)
+                {
+                    entries[i].buffer.refresh(descriptor.entries[i].buffer);
+                    entries[i].sampler.refresh(descriptor.entries[i].sampler);
+                    entries[i].texture_view.refresh(descriptor.entries[i].texture_view);
+                }
+                handle = device.create_bind_group(descriptor);
+            }
+
+            TrackedReference<BindGroupLayout, WGPUBindGroupLayout> layout;
+            std::vector<EntryReferences> entries;
+        };
+
+        // Moves the callback into a pooled slot, which is handed to WebGPU as the user data. Every WebGPU callback
+        // fires exactly once, even when the operation fails, so invoke_pooled_callback releases the slot after
+        // running it and callers have nothing to keep alive.
+        template<typename Callback>
+        Callback * make_pooled_callback(Callback &&callback)
+        {
+            static_assert(sizeof(Callback) <= CallbackPool::slot_size);
+            static_assert(alignof(Callback) <= alignof(std::max_align_t));
+            return ::new (CallbackPool::get().allocate()) Callback(std::move(callback));
+        }
+
+        template<typename Callback, typename... Args>
+        void invoke_pooled_callback(void *user_data, Args &&...args)
+        {
+            auto *callback = static_cast<Callback *>(user_data);
+            (*callback)(std::forward<Args>(args)...);
+
+            std::destroy_at(callback);
+            CallbackPool::get().deallocate(callback);
+        }
+
+        void on_device_lost(const WGPUDeviceLostReason reason, const char *message, void *user_data)
+        {
+            invoke_pooled_callback<DeviceLostCallback>(user_data, static_cast<DeviceLostReason>(reason),
+                std::string{message ? message : ""});
+        }
+
+        // The user data is the device's ErrorSink, or nullptr if it has none.
+        void on_uncaptured_error(const WGPUErrorType type, const char *message, void *user_data)
+        {
+            const std::string_view text = message ? message : "";
+            if (auto *error_sink = static_cast<ErrorSink *>(user_data))
+            {
+                (void) error_sink->push(static_cast<ErrorType>(type), text);
+                return;
+            }
+            std::cerr << "Uncaptured error: " << text << '\n';
+        }
+
+#ifdef WEBGPU_BACKEND_WGPU
+        // wgpu-native takes the uncaptured error callback once the device exists, not through its descriptor.
+        void set_uncaptured_error_callback(const Device &device, ErrorSink *error_sink)
+        {
+            wgpuDeviceSetUncapturedErrorCallback(device.c_ptr(), on_uncaptured_error, error_sink);
+        }
+#endif
+
+        // Made next to each device request rather than while translating the descriptor, so that the slot belongs
+        // to exactly one request. Returns nullptr when the descriptor has no device lost callback.
+        DeviceLostCallback * make_device_lost_callback(const DeviceDescriptor &descriptor)
+        {
+            return descriptor.device_lost_callback
+                ? make_pooled_callback(DeviceLostCallback{descriptor.device_lost_callback}) : nullptr;
+        }
+
+        // Called when a device request fails. wgpu-native never fires the device lost callback of a device it could
+        // not create, so the slot is freed here. Dawn fires it with DeviceLostReason::FailedCreation, which frees it.
+        void release_device_lost_callback(DeviceLostCallback *callback)
+        {
+#ifdef WEBGPU_BACKEND_WGPU
+            if (callback)
+            {
+                std::destroy_at(callback);
+                CallbackPool::get().deallocate(callback);
+            }
+#else
+            (void) callback;
+#endif
+        }
+
+        // Pooled in place of a bare RequestDeviceCallback so the error sink reaches the device on wgpu-native.
+        struct PendingDeviceRequest
+        {
+            void operator()(const RequestDeviceStatus status, const Device &device, const std::string &message)
+            {
+                if (status == RequestDeviceStatus::Success)
+                {
+#ifdef WEBGPU_BACKEND_WGPU
+                    set_uncaptured_error_callback(device, error_sink);
+#endif
+                }
+                else
+                {
+                    release_device_lost_callback(device_lost_callback);
+                }
+                callback(status, device, message);
+            }
+
+            RequestDeviceCallback callback;
+            ErrorSink *error_sink;
+            DeviceLostCallback *device_lost_callback;
+        };
+
+        // The returned descriptor points into the source descriptor, so it must not outlive it. The device lost
+        // callback comes from make_device_lost_callback.
+        WGPUDeviceDescriptor translate_device_descriptor(const DeviceDescriptor &descriptor,
+            DeviceLostCallback *device_lost_callback)
+        {
+            return WGPUDeviceDescriptor
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+                .label = descriptor.label.c_str(),
+                .requiredFeatureCount = descriptor.required_features.size(),
+                .requiredFeatures = reinterpret_cast<const WGPUFeatureName *>(descriptor.required_features.data()),
+                .requiredLimits = reinterpret_cast<const WGPURequiredLimits *>(descriptor.required_limits),
+                .defaultQueue = {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.default_queue.next_in_chain),
+                    .label = descriptor.default_queue.label.c_str()
+                },
+                // Once the device exists, the callback fires exactly once, when it is lost or released, which frees
+                // its slot.
+                .deviceLostCallback = device_lost_callback ? on_device_lost : nullptr,
+                .deviceLostUserdata = device_lost_callback,
+#ifdef WEBGPU_BACKEND_DAWN
+                .deviceLostCallbackInfo = {},
+                .uncapturedErrorCallbackInfo = {
+                    .callback = on_uncaptured_error,
+                    .userdata = descriptor.error_sink,
+                },
+#endif
+            };
+        }
+
+        WGPURequestAdapterOptions translate_request_adapter_options(const RequestAdapterOptions &options)
+        {
+            return WGPURequestAdapterOptions
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(options.next_in_chain),
+                .compatibleSurface = options.compatible_surface ? options.compatible_surface->c_ptr() : nullptr,
+                .powerPreference = static_cast<WGPUPowerPreference>(options.power_preference),
+                .backendType = static_cast<WGPUBackendType>(options.backend_type),
+                .forceFallbackAdapter = options.force_fallback_adapter,
+#ifdef WEBGPU_BACKEND_DAWN
+                .compatibilityMode = options.compatibility_mode,
+#endif
+            };
+        }
+
+        // Calls pump until is_done returns true or the deadline passes. Returns whether is_done was satisfied.
+        template<typename IsDone, typename Pump>
+        bool wait_until(const WaitOptions &options, IsDone &&is_done, Pump &&pump)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + options.timeout;
+
+            while (!is_done())
+            {
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return false;
+                }
+
+                pump();
+                if (is_done())
+                {
+                    break;
+                }
+
+#ifdef __EMSCRIPTEN__
+                // Spinning would never yield to the browser, so both strategies have to sleep here.
+                emscripten_sleep(std::chrono::ceil<std::chrono::milliseconds>(options.sleep_interval).count());
+#else
+                if (options.strategy == WaitStrategy::Sleep)
+                {
+                    std::this_thread::sleep_for(options.sleep_interval);
+                }
+#endif
+            }
+
+            return true;
+        }
+    }
+
+    std::expected<Device, std::string> Adapter::create_device(const DeviceDescriptor &descriptor,
+        const WaitOptions &wait_options) const
+    {
+        // The callback may outlive this call if the request times out, so it shares ownership of the result.
+        struct State
+        {
+            std::expected<Device, std::string> result = std::unexpected("Request did not end.");
+            bool request_ended = false;
+        };
+        const auto state = std::make_shared<State>();
+
+        auto on_device_request_ended = [state](const RequestDeviceStatus status, const Device& device,
+            const std::string &message)
+        {
+            if (status == RequestDeviceStatus::Success)
+            {
+                state->result = device;
+            }
+            else
+            {
+                state->result = std::unexpected(message);
+            }
+            state->request_ended = true;
+        };
+
+        request_device(descriptor, std::move(on_device_request_ended));
+
+#ifdef WEBGPU_BACKEND_DAWN
+        const Instance instance{wgpuAdapterGetInstance(m_handle)};
+#endif
+        const auto request_ended = wait_until(wait_options, [&state] { return state->request_ended; }, [&]
+        {
+#ifdef WEBGPU_BACKEND_DAWN
+            instance.process_events();
+#endif
+        });
+
+        if (!request_ended)
+        {
+            return std::unexpected("Request timed out.");
+        }
+
+        return std::move(state->result);
+    }
+
+    std::expected<Device, std::string> Adapter::create_device(const DeviceDescriptor &descriptor) const
+    {
+        return create_device(descriptor, WaitOptions{});
+    }
+
+    std::vector<FeatureName> Adapter::enumerate_features() const
+    {
+        const auto feature_count = wgpuAdapterEnumerateFeatures(m_handle, nullptr);
+
+        std::vector<FeatureName> features(feature_count);
+        wgpuAdapterEnumerateFeatures(m_handle, reinterpret_cast<WGPUFeatureName*>(features.data()));
+
+        return features;
+    }
+
+    std::optional<SupportedLimits> Adapter::get_limits() const
+    {
+        WGPUSupportedLimits wgpu_supported_limits{};
+        const auto result = wgpuAdapterGetLimits(m_handle, &wgpu_supported_limits);
+
+#ifdef WEBGPU_BACKEND_WGPU
+        if (!result)
+#endif
+#ifdef WEBGPU_BACKEND_DAWN
+        if (result != WGPUStatus_Success)
+#endif
+        {
+            return std::nullopt;
+        }
+
+        return *reinterpret_cast<SupportedLimits *>(&wgpu_supported_limits);
+    }
+
+    std::optional<AdapterProperties> Adapter::get_properties() const
+    {
+        WGPUAdapterProperties wgpu_properties{};
+#ifdef WEBGPU_BACKEND_WGPU
+        wgpuAdapterGetProperties(m_handle, &wgpu_properties);
+#endif
+#ifdef WEBGPU_BACKEND_DAWN
+        if (wgpuAdapterGetProperties(m_handle, &wgpu_properties) != WGPUStatus_Success)
+        {
+            return std::nullopt;
+        }
+#endif
+
+        return AdapterProperties{
+            .next_in_chain = reinterpret_cast<ChainedStructOut *>(wgpu_properties.nextInChain),
+            .vendor_id = wgpu_properties.vendorID,
+            .vendor_name = wgpu_properties.vendorName,
+            .architecture = wgpu_properties.architecture,
+            .device_id = wgpu_properties.deviceID,
+            .name = wgpu_properties.name,
+            .driver_description = wgpu_properties.driverDescription,
+            .adapter_type = static_cast<AdapterType>(wgpu_properties.adapterType),
+            .backend_type = static_cast<BackendType>(wgpu_properties.backendType),
+        };
+    }
+
+    bool Adapter::has_feature(const FeatureName feature) const
+    {
+        return wgpuAdapterHasFeature(m_handle, static_cast<WGPUFeatureName>(feature));
+    }
+
+    void Adapter::request_device(const DeviceDescriptor &descriptor, RequestDeviceCallback &&callback) const
+    {
+        static auto on_request_ended = [](WGPURequestDeviceStatus status, WGPUDevice device,
+            const char *message, void *user_data) -> void
+        {
+            invoke_pooled_callback<PendingDeviceRequest>(user_data, static_cast<RequestDeviceStatus>(status),
+                Device{device}, std::string{message ? message : ""});
+        };
+
+        auto *device_lost_callback = make_device_lost_callback(descriptor);
+        const auto wgpu_descriptor = translate_device_descriptor(descriptor, device_lost_callback);
+        wgpuAdapterRequestDevice(m_handle, &wgpu_descriptor, on_request_ended,
+            make_pooled_callback(PendingDeviceRequest{
+                .callback = std::move(callback),
+                .error_sink = descriptor.error_sink,
+                .device_lost_callback = device_lost_callback,
+            }));
+    }
+
+    DeviceRequestAwaitable Adapter::request_device(Executor &executor, const DeviceDescriptor &descriptor) const
+    {
+        return DeviceRequestAwaitable{executor, *this, descriptor};
+    }
+
+    const void * Buffer::get_const_mapped_range(const size_t offset, const size_t size) const
+    {
+        return wgpuBufferGetConstMappedRange(m_handle, offset, size);
+    }
+
+    void * Buffer::get_mapped_range(const size_t offset, const size_t size) const
+    {
+        return wgpuBufferGetMappedRange(m_handle, offset, size);
+    }
+
+    void Buffer::map_async(const MapModeFlags mode, const size_t offset, const size_t size,
+        MapBufferCallback &&callback) const
+    {
         static auto on_buffer_mapped = [](const WGPUBufferMapAsyncStatus status, void *user_data) -> void
         {
-            const MapBufferCallback& callback = *static_cast<MapBufferCallback*>(user_data);
-            callback(static_cast<BufferMapAsyncStatus>(status));
+            invoke_pooled_callback<MapBufferCallback>(user_data, static_cast<BufferMapAsyncStatus>(status));
+        };
+
+        wgpuBufferMapAsync(m_handle, static_cast<WGPUMapModeFlags>(mode), offset, size, on_buffer_mapped,
+            make_pooled_callback(std::move(callback)));
+    }
+
+    BufferMapAwaitable Buffer::map_async(Executor &executor, const MapModeFlags mode, const size_t offset,
+        const size_t size) const
+    {
+        return BufferMapAwaitable{executor, *this, mode, offset, size};
+    }
+
+    void Buffer::unmap() const
+    {
+        wgpuBufferUnmap(m_handle);
+    }
+
+    ComputePassEncoder CommandEncoder::begin_compute_pass(const ComputePassDescriptor &descriptor) const
+    {
+        WGPUComputePassTimestampWrites wgpu_timestamp_writes{};
+        if (descriptor.timestamp_writes)
+        {
+            wgpu_timestamp_writes = WGPUComputePassTimestampWrites
+            {
+                .querySet = descriptor.timestamp_writes->query_set.c_ptr(),
+                .beginningOfPassWriteIndex = descriptor.timestamp_writes->beginning_of_pass_write_index,
+                .endOfPassWriteIndex = descriptor.timestamp_writes->end_of_pass_write_index,
+            };
+        }
+
+        const WGPUComputePassDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .timestampWrites = descriptor.timestamp_writes ? &wgpu_timestamp_writes : nullptr,
+        };
+
+        return ComputePassEncoder{wgpuCommandEncoderBeginComputePass(m_handle, &wgpu_descriptor)};
+    }
+
+    RenderPassEncoder CommandEncoder::begin_render_pass(const RenderPassDescriptor &descriptor) const
+    {
+        auto &arena = FrameArena::get_thread_local();
+        const FrameArenaScope arena_scope{arena};
+
+        const auto wgpu_color_attachments = arena.allocate<WGPURenderPassColorAttachment>(
+            descriptor.color_attachments.size());
+        for (size_t i = 0; i < descriptor.color_attachments.size(); ++i)
+        {
+            const auto &color_attachment = descriptor.color_attachments[i];
+            wgpu_color_attachments[i] = WGPURenderPassColorAttachment
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(color_attachment.next_in_chain),
+                .view = color_attachment.view.c_ptr(),
+#ifdef WEBGPU_BACKEND_DAWN
+                .depthSlice = color_attachment.depth_slice,
+#endif
+                .resolveTarget = color_attachment.resolve_target.c_ptr(),
+                .loadOp = static_cast<WGPULoadOp>(color_attachment.load_op),
+                .storeOp = static_cast<WGPUStoreOp>(color_attachment.store_op),
+                .clearValue = *reinterpret_cast<const WGPUColor*>(&color_attachment.clear_value),
+            };
+        }
+
+        WGPURenderPassDepthStencilAttachment wgpu_depth_stencil_attachment{};
+        if (descriptor.depth_stencil_attachment)
+        {
+            wgpu_depth_stencil_attachment = WGPURenderPassDepthStencilAttachment
+            {
+                .view = descriptor.depth_stencil_attachment->view.c_ptr(),
+                .depthLoadOp = static_cast<WGPULoadOp>(descriptor.depth_stencil_attachment->depth_load_op),
+                .depthStoreOp = static_cast<WGPUStoreOp>(descriptor.depth_stencil_attachment->depth_store_op),
+                .depthClearValue = descriptor.depth_stencil_attachment->depth_clear_value,
+                .stencilLoadOp = static_cast<WGPULoadOp>(descriptor.depth_stencil_attachment->stencil_load_op),
+                .stencilStoreOp = static_cast<WGPUStoreOp>(descriptor.depth_stencil_attachment->stencil_store_op),
+                .stencilClearValue = descriptor.depth_stencil_attachment->stencil_clear_value,
+                .stencilReadOnly = descriptor.depth_stencil_attachment->stencil_read_only,
+            };
+        }
+
+        WGPURenderPassTimestampWrites wgpu_timestamp_writes{};
+        if (descriptor.timestamp_writes)
+        {
+            wgpu_timestamp_writes = WGPURenderPassTimestampWrites
+            {
+                .querySet = descriptor.timestamp_writes->query_set.c_ptr(),
+                .beginningOfPassWriteIndex = descriptor.timestamp_writes->beginning_of_pass_write_index,
+                .endOfPassWriteIndex = descriptor.timestamp_writes->end_of_pass_write_index,
+            };
+        }
+
+        const WGPURenderPassDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .colorAttachmentCount = wgpu_color_attachments.size(),
+            .colorAttachments = wgpu_color_attachments.data(),
+            .depthStencilAttachment = descriptor.depth_stencil_attachment ? &wgpu_depth_stencil_attachment : nullptr,
+            .occlusionQuerySet = descriptor.occlusion_query_set.c_ptr(),
+            .timestampWrites = descriptor.timestamp_writes ? &wgpu_timestamp_writes : nullptr,
+        };
+
+        return RenderPassEncoder{wgpuCommandEncoderBeginRenderPass(m_handle, &wgpu_descriptor)};
+    }
+
+    void CommandEncoder::copy_buffer_to_buffer(const Buffer &source, const uint64_t source_offset,
+        const Buffer &destination, const uint64_t destination_offset, const uint64_t size) const
+    {
+        wgpuCommandEncoderCopyBufferToBuffer(
+            m_handle,
+            source.c_ptr(), source_offset,
+            destination.c_ptr(), destination_offset,
+            size
+        );
+    }
+
+
+    CommandBuffer CommandEncoder::finish(const CommandBufferDescriptor &descriptor) const
+    {
+        const WGPUCommandBufferDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+        };
+
+        return CommandBuffer{wgpuCommandEncoderFinish(m_handle, &wgpu_descriptor)};
+    }
+
+    void CommandEncoder::resolve_query_set(const QuerySet &query_set, const uint32_t first_query,
+        const uint32_t query_count, const Buffer &destination, const uint64_t destination_offset) const
+    {
+        wgpuCommandEncoderResolveQuerySet(m_handle, query_set.c_ptr(), first_query, query_count, destination.c_ptr(),
+            destination_offset);
+    }
+
+    void CommandEncoder::write_timestamp(const QuerySet &query_set, const uint32_t query_index) const
+    {
+        wgpuCommandEncoderWriteTimestamp(m_handle, query_set.c_ptr(), query_index);
+    }
+
+    void ComputePassEncoder::end() const
+    {
+        wgpuComputePassEncoderEnd(m_handle);
+    }
+
+    BindGroupLayout ComputePipeline::get_bind_group_layout(const uint32_t group_index) const
+    {
+        return BindGroupLayout{wgpuComputePipelineGetBindGroupLayout(m_handle, group_index)};
+    }
+
+    BindGroup Device::create_bind_group(const BindGroupDescriptor &descriptor) const
+    {
+        auto &arena = FrameArena::get_thread_local();
+        const FrameArenaScope arena_scope{arena};
+
+        const auto wgpu_entries = arena.allocate<WGPUBindGroupEntry>(descriptor.entries.size());
+        for (size_t i = 0; i < descriptor.entries.size(); ++i)
+        {
+            const BindGroupEntry &entry = descriptor.entries[i];
+            wgpu_entries[i] = WGPUBindGroupEntry
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.next_in_chain),
+                .binding = entry.binding,
+                .buffer = entry.buffer.c_ptr(),
+                .offset = entry.offset,
+                .size = entry.size,
+                .sampler = entry.sampler.c_ptr(),
+                .textureView = entry.texture_view.c_ptr(),
+            };
+        }
+
+        const WGPUBindGroupDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .layout = descriptor.layout.c_ptr(),
+            .entryCount = wgpu_entries.size(),
+            .entries = wgpu_entries.data(),
+        };
+
+        return BindGroup{wgpuDeviceCreateBindGroup(m_handle, &wgpu_descriptor)};
+    }
+
+    BindGroupLayout Device::create_bind_group_layout(const BindGroupLayoutDescriptor &descriptor) const
+    {
+        auto &arena = FrameArena::get_thread_local();
+        const FrameArenaScope arena_scope{arena};
+
+        const auto wgpu_entries = arena.allocate<WGPUBindGroupLayoutEntry>(descriptor.entries.size());
+        for (size_t i = 0; i < descriptor.entries.size(); ++i)
+        {
+            const BindGroupLayoutEntry &entry = descriptor.entries[i];
+            wgpu_entries[i] = WGPUBindGroupLayoutEntry
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.next_in_chain),
+                .binding = entry.binding,
+                .visibility = static_cast<WGPUShaderStageFlags>(entry.visibility),
+                .buffer = WGPUBufferBindingLayout
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.buffer.next_in_chain),
+                    .type = static_cast<WGPUBufferBindingType>(entry.buffer.type),
+                    .hasDynamicOffset = entry.buffer.has_dynamic_offset,
+                    .minBindingSize = entry.buffer.min_binding_size,
+                },
+                .sampler = WGPUSamplerBindingLayout
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.sampler.next_in_chain),
+                    .type = static_cast<WGPUSamplerBindingType>(entry.sampler.type),
+                },
+                .texture = WGPUTextureBindingLayout
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.texture.next_in_chain),
+                    .sampleType = static_cast<WGPUTextureSampleType>(entry.texture.sample_type),
+                    .viewDimension = static_cast<WGPUTextureViewDimension>(entry.texture.view_dimension),
+                    .multisampled = entry.texture.multisampled,
+                },
+                .storageTexture = WGPUStorageTextureBindingLayout
+                {
+                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.storage_texture.next_in_chain),
+                    .access = static_cast<WGPUStorageTextureAccess>(entry.storage_texture.access),
+                    .format = static_cast<WGPUTextureFormat>(entry.storage_texture.format),
+                    .viewDimension = static_cast<WGPUTextureViewDimension>(entry.storage_texture.view_dimension),
+                },
+            };
+        }
+
+        const WGPUBindGroupLayoutDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .entryCount = wgpu_entries.size(),
+            .entries = wgpu_entries.data(),
+        };
+
+        return BindGroupLayout{wgpuDeviceCreateBindGroupLayout(m_handle, &wgpu_descriptor)};
+    }
+
+    Buffer Device::create_buffer(const BufferDescriptor &descriptor) const
+    {
+        const WGPUBufferDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .usage = static_cast<WGPUBufferUsageFlags>(descriptor.usage),
+            .size = descriptor.size,
+            .mappedAtCreation = descriptor.mapped_at_creation,
+        };
+
+        return Buffer{wgpuDeviceCreateBuffer(m_handle, &wgpu_descriptor)};
+    }
+
+    static_assert(std::is_trivially_copyable_v<CommandEncoderDescriptor>);
+    static_assert(std::is_trivially_copyable_v<CommandBufferDescriptor>);
+
+    CommandEncoder Device::create_command_encoder(const CommandEncoderDescriptor &descriptor) const
+    {
+        const WGPUCommandEncoderDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+        };
+
+        return CommandEncoder{wgpuDeviceCreateCommandEncoder(m_handle, &wgpu_descriptor)};
+    }
+
+    ComputePipeline Device::create_compute_pipeline(const ComputePipelineDescriptor &descriptor) const
+    {
+        auto &arena = FrameArena::get_thread_local();
+        const FrameArenaScope arena_scope{arena};
+
+        const auto wgpu_constants = translate_constants(descriptor.compute.constants, arena);
+
+        const WGPUComputePipelineDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .layout = descriptor.layout.c_ptr(),
+            .compute = WGPUProgrammableStageDescriptor
+            {
+                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.compute.next_in_chain),
+                .module = descriptor.compute.module.c_ptr(),
+                .entryPoint = descriptor.compute.entry_point ? descriptor.compute.entry_point->c_str() : nullptr,
+                .constantCount = wgpu_constants.size(),
+                .constants = wgpu_constants.data(),
+            },
+        };
+
+        return ComputePipeline{wgpuDeviceCreateComputePipeline(m_handle, &wgpu_descriptor)};
+    }
+
+    PipelineLayout Device::create_pipeline_layout(const PipelineLayoutDescriptor &descriptor) const
+    {
+        // BindGroupLayoutRef only wraps its handle, so the layouts can be passed straight through.
+        static_assert(sizeof(BindGroupLayoutRef) == sizeof(WGPUBindGroupLayout));
+
+        const WGPUPipelineLayoutDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .bindGroupLayoutCount = descriptor.bind_group_layouts.size(),
+            .bindGroupLayouts = reinterpret_cast<const WGPUBindGroupLayout *>(descriptor.bind_group_layouts.data()),
+        };
+
+        return PipelineLayout{wgpuDeviceCreatePipelineLayout(m_handle, &wgpu_descriptor)};
+    }
+
+    QuerySet Device::create_query_set(const QuerySetDescriptor &descriptor) const
+    {
+        const WGPUQuerySetDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .type = static_cast<WGPUQueryType>(descriptor.type),
+            .count = descriptor.count,
+        };
+
+        return QuerySet{wgpuDeviceCreateQuerySet(m_handle, &wgpu_descriptor)};
+    }
+
+    RenderBundleEncoder Device::create_render_bundle_encoder(const RenderBundleEncoderDescriptor &descriptor) const
+    {
+        const WGPURenderBundleEncoderDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .colorFormatCount = descriptor.color_formats.size(),
+            .colorFormats = reinterpret_cast<const WGPUTextureFormat *>(descriptor.color_formats.data()),
+            .depthStencilFormat = static_cast<WGPUTextureFormat>(descriptor.depth_stencil_format),
+            .sampleCount = descriptor.sample_count,
+            .depthReadOnly = descriptor.depth_read_only,
+            .stencilReadOnly = descriptor.stencil_read_only,
+        };
+
+        return RenderBundleEncoder{wgpuDeviceCreateRenderBundleEncoder(m_handle, &wgpu_descriptor)};
+    }
+
+    RenderPipeline Device::create_render_pipeline(const RenderPipelineDescriptor &descriptor) const
+    {
+        auto &arena = FrameArena::get_thread_local();
+        const FrameArenaScope arena_scope{arena};
+
+        const auto wgpu_descriptor = translate_render_pipeline_descriptor(descriptor, arena);
+        return RenderPipeline{wgpuDeviceCreateRenderPipeline(m_handle, &wgpu_descriptor)};
+    }
+
+    void Device::create_render_pipeline_async(const RenderPipelineDescriptor &descriptor,
+        CreateRenderPipelineCallback &&callback) const
+    {
+        auto pending = std::make_unique<PendingRenderPipeline>(*this, descriptor, std::move(callback));
+
+#ifdef WEBGPU_BACKEND_WGPU
+        RenderPipelineCompileQueue::get().push(std::move(pending));
+#else
+        static auto on_pipeline_created = [](WGPUCreatePipelineAsyncStatus status, WGPURenderPipeline pipeline,
+            const char *message, void *user_data) -> void
+        {
+            const std::unique_ptr<PendingRenderPipeline> pending{static_cast<PendingRenderPipeline *>(user_data)};
+            pending->callback(static_cast<CreatePipelineAsyncStatus>(status), RenderPipeline{pipeline},
+                message ? message : "");
+        };
+
+        // Taken before release(), since the order arguments are evaluated in is unspecified.
+        const auto *wgpu_descriptor = &pending->wgpu_descriptor;
+        wgpuDeviceCreateRenderPipelineAsync(m_handle, wgpu_descriptor, on_pipeline_created, pending.release());
+#endif
+    }
+
+    AsyncRenderPipeline Device::create_render_pipeline_async(const RenderPipelineDescriptor &descriptor) const
+    {
+        AsyncRenderPipeline async_pipeline;
+        create_render_pipeline_async(descriptor,
+            [state = async_pipeline.m_state](const CreatePipelineAsyncStatus status, const RenderPipeline &pipeline,
+                const std::string &message)
+            {
+                if (status == CreatePipelineAsyncStatus::Success)
+                {
+                    state->result = pipeline;
+                }
+                else
+                {
+                    state->result = std::unexpected(message);
+                }
+                state->ready.store(true, std::memory_order_release);
+            });
+
+        return async_pipeline;
+    }
+
+    RenderPipelineCreateAwaitable Device::create_render_pipeline_async(Executor &executor,
+        const RenderPipelineDescriptor &descriptor) const
+    {
+        return RenderPipelineCreateAwaitable{executor, *this, descriptor};
+    }
+
+    Sampler Device::create_sampler(const SamplerDescriptor &descriptor) const
+    {
+        const WGPUSamplerDescriptor wgpu_sampler_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .addressModeU = static_cast<WGPUAddressMode>(descriptor.address_mode_u),
+            .addressModeV = static_cast<WGPUAddressMode>(descriptor.address_mode_v),
+            .addressModeW = static_cast<WGPUAddressMode>(descriptor.address_mode_w),
+            .magFilter = static_cast<WGPUFilterMode>(descriptor.mag_filter),
+            .minFilter = static_cast<WGPUFilterMode>(descriptor.min_filter),
+            .mipmapFilter = static_cast<WGPUMipmapFilterMode>(descriptor.mipmap_filter),
+            .lodMinClamp = descriptor.lod_min_clamp,
+            .lodMaxClamp = descriptor.lod_max_clamp,
+            .compare = static_cast<WGPUCompareFunction>(descriptor.compare),
+            .maxAnisotropy = descriptor.max_anistropy,
+        };
+
+        return Sampler{wgpuDeviceCreateSampler(m_handle, &wgpu_sampler_descriptor)};
+    }
+
+    ShaderModule Device::create_shader_module(const ShaderModuleDescriptor &descriptor) const
+    {
+        const WGPUShaderModuleDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+#ifdef WEBGPU_BACKEND_WGPU
+            .hintCount = 0,
+            .hints = nullptr,
+#endif
+        };
+
+        return ShaderModule{wgpuDeviceCreateShaderModule(m_handle, &wgpu_descriptor)};
+    }
+
+    Texture Device::create_texture(const TextureDescriptor &descriptor) const
+    {
+        const WGPUTextureDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .usage = static_cast<WGPUTextureUsageFlags>(descriptor.usage),
+            .dimension = static_cast<WGPUTextureDimension>(descriptor.dimension),
+            .size = WGPUExtent3D
+            {
+                .width = descriptor.size.width,
+                .height = descriptor.size.height,
+                .depthOrArrayLayers = descriptor.size.depth_or_array_layers,
+            },
+            .format = static_cast<WGPUTextureFormat>(descriptor.format),
+            .mipLevelCount = descriptor.mip_level_count,
+            .sampleCount = descriptor.sample_count,
+            .viewFormatCount = descriptor.view_formats.size(),
+            .viewFormats = reinterpret_cast<const WGPUTextureFormat *>(descriptor.view_formats.data()),
+        };
+
+        return Texture{wgpuDeviceCreateTexture(m_handle, &wgpu_descriptor)};
+    }
+
+    std::optional<SupportedLimits> Device::get_limits() const
+    {
+        WGPUSupportedLimits wgpu_supported_limits{};
+        const auto result = wgpuDeviceGetLimits(m_handle, &wgpu_supported_limits);
+
+#ifdef WEBGPU_BACKEND_WGPU
+        if (!result)
+#endif
+#ifdef WEBGPU_BACKEND_DAWN
+        if (result != WGPUStatus_Success)
+#endif
+        {
+            return std::nullopt;
+        }
+
+        return *reinterpret_cast<SupportedLimits *>(&wgpu_supported_limits);
+    }
+
+    Queue Device::get_queue() const
+    {
+        return Queue{wgpuDeviceGetQueue(m_handle)};
+    }
+
+    void Device::pop_error_scope(PopErrorScopeCallback &&callback) const
+    {
+        static auto on_error_scope_popped = [](const WGPUErrorType type, const char *message, void *user_data) -> void
+        {
+            invoke_pooled_callback<PopErrorScopeCallback>(user_data, static_cast<ErrorType>(type),
+                std::string{message ? message : ""});
+        };
+
+#ifdef WEBGPU_BACKEND_WGPU
+        const std::lock_guard lock{get_error_scope_mutex()};
+#endif
+        wgpuDevicePopErrorScope(m_handle, on_error_scope_popped, make_pooled_callback(std::move(callback)));
+    }
+
+    ErrorScopeAwaitable Device::pop_error_scope(Executor &executor) const
+    {
+        return ErrorScopeAwaitable{executor, *this};
+    }
+
+    void Device::push_error_scope(const ErrorFilter filter) const
+    {
+#ifdef WEBGPU_BACKEND_WGPU
+        const std::lock_guard lock{get_error_scope_mutex()};
+#endif
+        wgpuDevicePushErrorScope(m_handle, static_cast<WGPUErrorFilter>(filter));
+    }
+
+    void Device::tick() const
+    {
+#ifdef WEBGPU_BACKEND_WGPU
+        wgpuDevicePoll(m_handle, false, nullptr);
+#endif
+#ifdef WEBGPU_BACKEND_DAWN
+        wgpuDeviceTick(m_handle);
+#endif
+    }
+
+    PipelineWarmUpResult Device::warm_up_render_pipelines(const std::span<const RenderPipelineDescriptor> descriptors,
+        ThreadPool &pool, const WaitOptions &wait_options) const
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        PipelineWarmUpResult result
+        {
+            .pipelines = std::vector<std::expected<RenderPipeline, std::string>>(descriptors.size()),
+            .compile_times = std::vector<std::chrono::nanoseconds>(descriptors.size()),
+        };
+
+#ifdef WEBGPU_BACKEND_WGPU
+        (void) wait_options;
+
+        // One validation error scope covers the whole batch, so the pipelines still compile concurrently. Scopes
+        // only keep their first error, so if the batch raised one, each pipeline is created again in its own scope
+        // to find out which descriptors failed, as the asynchronous path reports them.
+        const auto batch_error = capture_validation_error(*this, [&]
+        {
+            pool.parallel_for(descriptors.size(), [&](const size_t index)
+            {
+                const auto pipeline_start = std::chrono::steady_clock::now();
+                result.pipelines[index] = create_render_pipeline(descriptors[index]);
+                result.compile_times[index] = std::chrono::steady_clock::now() - pipeline_start;
+            });
+        });
+
+        if (batch_error)
+        {
+            for (size_t i = 0; i < descriptors.size(); ++i)
+            {
+                RenderPipeline pipeline;
+                const auto error = capture_validation_error(*this, [this, &descriptors, &pipeline, i]
+                {
+                    pipeline = create_render_pipeline(descriptors[i]);
+                });
+
+                if (error)
+                {
+                    result.pipelines[i] = std::unexpected(*error);
+                }
+                else
+                {
+                    result.pipelines[i] = std::move(pipeline);
+                }
+            }
+        }
+#else
+        (void) pool;
+
+        // Shared with the callbacks, which can still fire after a timeout.
+        struct State
+        {
+            std::mutex mutex;
+            PipelineWarmUpResult result;
+            size_t remaining;
+        };
+        const auto state = std::make_shared<State>();
+        state->result = std::move(result);
+        state->remaining = descriptors.size();
+
+        for (size_t i = 0; i < descriptors.size(); ++i)
+        {
+            state->result.pipelines[i] = std::unexpected("Request timed out.");
+            create_render_pipeline_async(descriptors[i],
+                [state, i, pipeline_start = std::chrono::steady_clock::now()](const CreatePipelineAsyncStatus status,
+                    const RenderPipeline &pipeline, const std::string &message)
+                {
+                    const std::lock_guard lock{state->mutex};
+                    if (status == CreatePipelineAsyncStatus::Success)
+                    {
+                        state->result.pipelines[i] = pipeline;
+                    }
+                    else
+                    {
+                        state->result.pipelines[i] = std::unexpected(message);
+                    }
+                    state->result.compile_times[i] = std::chrono::steady_clock::now() - pipeline_start;
+                    --state->remaining;
+                });
+        }
+
+        // The callbacks fire from Instance::process_events, so pump the instance as create_device does.
+        const Adapter adapter{wgpuDeviceGetAdapter(m_handle)};
+        const Instance instance{wgpuAdapterGetInstance(adapter.c_ptr())};
+        (void) wait_until(wait_options, [&state]
+        {
+            const std::lock_guard lock{state->mutex};
+            return state->remaining == 0;
+        }, [&]
+        {
+            instance.process_events();
+            tick();
+        });
+
+        {
+            const std::lock_guard lock{state->mutex};
+            result = state->result;
+        }
+#endif
+
+        result.total_time = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+
+    PipelineWarmUpResult Device::warm_up_render_pipelines(const std::span<const RenderPipelineDescriptor> descriptors,
+        ThreadPool &pool) const
+    {
+        // A cold start can compile hundreds of pipelines, so allow far longer than a single request gets.
+        return warm_up_render_pipelines(descriptors, pool, WaitOptions{.timeout = std::chrono::minutes(1)});
+    }
+
+    std::expected<Adapter, std::string> Instance::create_adapter(const RequestAdapterOptions &options,
+        const WaitOptions &wait_options) const
+    {
+        // The callback may outlive this call if the request times out, so it shares ownership of the result.
+        struct State
+        {
+            std::expected<Adapter, std::string> result = std::unexpected("Request did not end.");
+            bool request_ended = false;
+        };
+        const auto state = std::make_shared<State>();
+
+        auto on_adapter_request_ended = [state](const RequestAdapterStatus status, const Adapter& adapter,
+            const std::string &message)
+        {
+            if (status == RequestAdapterStatus::Success)
+            {
+                state->result = adapter;
+            }
+            else
+            {
+                state->result = std::unexpected(message);
+            }
+            state->request_ended = true;
+        };
+
+        request_adapter(options, std::move(on_adapter_request_ended));
+
+        const auto request_ended = wait_until(wait_options, [&state] { return state->request_ended; }, [this]
+        {
+            process_events();
+        });
+
+        if (!request_ended)
+        {
+            return std::unexpected("Request timed out.");
+        }
+
+        return std::move(state->result);
+    }
+
+    std::expected<Adapter, std::string> Instance::create_adapter(const RequestAdapterOptions &options) const
+    {
+        return create_adapter(options, WaitOptions{});
+    }
+
+    void Instance::process_events() const
+    {
+        // wgpuInstanceProcessEvents exists on WGPU, but panics if called.
+#ifdef WEBGPU_BACKEND_DAWN
+        wgpuInstanceProcessEvents(m_handle);
+#endif
+    }
+
+    void Instance::request_adapter(const RequestAdapterOptions &options, RequestAdapterCallback &&callback) const
+    {
+        static auto on_request_ended = [](WGPURequestAdapterStatus status, WGPUAdapter adapter,
+            const char *message, void *user_data) -> void
+        {
+            invoke_pooled_callback<RequestAdapterCallback>(user_data, static_cast<RequestAdapterStatus>(status),
+                Adapter{adapter}, std::string{message ? message : ""});
+        };
+
+        const auto wgpu_options = translate_request_adapter_options(options);
+        wgpuInstanceRequestAdapter(m_handle, &wgpu_options, on_request_ended, make_pooled_callback(std::move(callback)));
+    }
+
+    AdapterRequestAwaitable Instance::request_adapter(Executor &executor, const RequestAdapterOptions &options) const
+    {
+        return AdapterRequestAwaitable{executor, *this, options};
+    }
+
+    void QuerySet::destroy() const
+    {
+        wgpuQuerySetDestroy(m_handle);
+    }
+
+    uint32_t QuerySet::get_count() const
+    {
+        return wgpuQuerySetGetCount(m_handle);
+    }
+
+    QueryType QuerySet::get_type() const
+    {
+        return static_cast<QueryType>(wgpuQuerySetGetType(m_handle));
+    }
+
+    void Queue::on_submitted_work_done(QueueWorkDoneCallback &&callback) const
+    {
+        static auto on_work_done = [](const WGPUQueueWorkDoneStatus status, void *user_data) -> void
+        {
+            invoke_pooled_callback<QueueWorkDoneCallback>(user_data, static_cast<QueueWorkDoneStatus>(status));
+        };
+
+        wgpuQueueOnSubmittedWorkDone(m_handle, on_work_done, make_pooled_callback(std::move(callback)));
+    }
+
+    QueueWorkDoneAwaitable Queue::on_submitted_work_done(Executor &executor) const
+    {
+        return QueueWorkDoneAwaitable{executor, *this};
+    }
+
+    void Queue::submit(const std::span<const CommandBuffer> commands) const
+    {
+        // CommandBuffer only wraps its handle, so the span can be passed straight through without a copy.
+        static_assert(sizeof(CommandBuffer) == sizeof(WGPUCommandBuffer));
+        wgpuQueueSubmit(m_handle, commands.size(), reinterpret_cast<const WGPUCommandBuffer *>(commands.data()));
+    }
+
+    void Queue::submit(const std::initializer_list<CommandBuffer> commands) const
+    {
+        submit(std::span{commands.begin(), commands.size()});
+    }
+
+    RenderBundle RenderBundleEncoder::finish(const RenderBundleDescriptor &descriptor) const
+    {
+        const WGPURenderBundleDescriptor wgpu_descriptor
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+        };
+
+        return RenderBundle{wgpuRenderBundleEncoderFinish(m_handle, &wgpu_descriptor)};
+    }
+
+    void RenderPassEncoder::end() const
+    {
+        wgpuRenderPassEncoderEnd(m_handle);
+    }
+
+    void RenderPassEncoder::execute_bundles(const std::span<const RenderBundle> bundles) const
+    {
+        static_assert(sizeof(RenderBundle) == sizeof(WGPURenderBundle));
+        wgpuRenderPassEncoderExecuteBundles(m_handle, bundles.size(),
+            reinterpret_cast<const WGPURenderBundle *>(bundles.data()));
+    }
+
+    void RenderPassEncoder::execute_bundles(const std::initializer_list<RenderBundle> bundles) const
+    {
+        execute_bundles(std::span{bundles.begin(), bundles.size()});
+    }
+
+    void RenderPassEncoder::multi_draw_indexed_indirect(const Buffer &indirect_buffer, const uint64_t indirect_offset,
+        const uint32_t count) const
+    {
+#ifdef WEBGPU_BACKEND_WGPU
+        wgpuRenderPassEncoderMultiDrawIndexedIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset, count);
+#else
+        // index_count, instance_count, first_index, base_vertex, first_instance
+        constexpr uint64_t stride = 5 * sizeof(uint32_t);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            wgpuRenderPassEncoderDrawIndexedIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset + i * stride);
+        }
+#endif
+    }
+
+    void RenderPassEncoder::multi_draw_indirect(const Buffer &indirect_buffer, const uint64_t indirect_offset,
+        const uint32_t count) const
+    {
+#ifdef WEBGPU_BACKEND_WGPU
+        wgpuRenderPassEncoderMultiDrawIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset, count);
+#else
+        // vertex_count, instance_count, first_vertex, first_instance
+        constexpr uint64_t stride = 4 * sizeof(uint32_t);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            wgpuRenderPassEncoderDrawIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset + i * stride);
+        }
+#endif
+    }
+
+#ifdef WEBGPU_BACKEND_WGPU
+    void RenderPassEncoder::multi_draw_indexed_indirect_count(const Buffer &indirect_buffer,
+        const uint64_t indirect_offset, const Buffer &count_buffer, const uint64_t count_buffer_offset,
+        const uint32_t max_count) const
+    {
+        wgpuRenderPassEncoderMultiDrawIndexedIndirectCount(m_handle, indirect_buffer.c_ptr(), indirect_offset,
+            count_buffer.c_ptr(), count_buffer_offset, max_count);
+    }
+
+    void RenderPassEncoder::multi_draw_indirect_count(const Buffer &indirect_buffer, const uint64_t indirect_offset,
+        const Buffer &count_buffer, const uint64_t count_buffer_offset, const uint32_t max_count) const
+    {
+        wgpuRenderPassEncoderMultiDrawIndirectCount(m_handle, indirect_buffer.c_ptr(), indirect_offset,
+            count_buffer.c_ptr(), count_buffer_offset, max_count);
+    }
+#endif
+
+    void Surface::configure(const SurfaceConfiguration &configuration) const
+    {
+        const WGPUSurfaceConfiguration wgpu_configuration
+        {
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(configuration.next_in_chain),
+            .device = configuration.device.c_ptr(),
+            .format = static_cast<WGPUTextureFormat>(configuration.format),
+            .usage = static_cast<WGPUTextureUsageFlags>(configuration.usage),
+            .viewFormatCount = configuration.view_formats.size(),
+            .viewFormats = reinterpret_cast<const WGPUTextureFormat *>(configuration.view_formats.data()),
+            .alphaMode = static_cast<WGPUCompositeAlphaMode>(configuration.alpha_mode),
+            .width = configuration.width,
+            .height = configuration.height,
+            .presentMode = static_cast<WGPUPresentMode>(configuration.present_mode),
+        };
+
+        wgpuSurfaceConfigure(m_handle, &wgpu_configuration);
+    }
+
+    SurfaceCapabilities Surface::get_capabilities(const Adapter &adapter) const
+    {
+        WGPUSurfaceCapabilities wgpu_capabilities{};
+        // TODO: On Dawn, this returns a WGPUStatus. This should be checked and handled.
+        // However, it only returns WGPUStatus_Error for some reason during testing.
+        wgpuSurfaceGetCapabilities(m_handle, adapter.c_ptr(), &wgpu_capabilities);
+
+        return SurfaceCapabilities
+        {
+            .next_in_chain = reinterpret_cast<ChainedStructOut *>(wgpu_capabilities.nextInChain),
+#ifdef WEBGPU_BACKEND_DAWN
+            .usages = static_cast<TextureUsageFlags>(wgpu_capabilities.usages),
+#endif
+            .formats = std::vector<TextureFormat>
+            {
+                reinterpret_cast<const TextureFormat *>(wgpu_capabilities.formats),
+                reinterpret_cast<const TextureFormat *>(wgpu_capabilities.formats) + wgpu_capabilities.formatCount
+            },
+            .present_modes = std::vector<PresentMode>
+            {
+                reinterpret_cast<const PresentMode *>(wgpu_capabilities.presentModes),
+                reinterpret_cast<const PresentMode *>(wgpu_capabilities.presentModes) + wgpu_capabilities.presentModeCount
+            },
+            .alpha_modes = std::vector<CompositeAlphaMode>
+            {
+                reinterpret_cast<const CompositeAlphaMode *>(wgpu_capabilities.alphaModes),
+                reinterpret_cast<const CompositeAlphaMode *>(wgpu_capabilities.alphaModes) + wgpu_capabilities.alphaModeCount
+            },
         };
+    }
 
-        wgpuBufferMapAsync(m_handle, static_cast<WGPUMapModeFlags>(mode), offset, size, on_buffer_mapped, handle.get());
+    SurfaceTexture Surface::get_current_texture() const
+    {
+        WGPUSurfaceTexture wgpu_surface_texture{};
+        wgpuSurfaceGetCurrentTexture(m_handle, &wgpu_surface_texture);
 
-        return handle;
+        return SurfaceTexture
+        {
+            .texture = Texture{wgpu_surface_texture.texture},
+            .suboptimal = static_cast<bool>(wgpu_surface_texture.suboptimal),
+            .status = static_cast<SurfaceGetCurrentTextureStatus>(wgpu_surface_texture.status),
+        };
     }
 
-    void Buffer::unmap() const
+    void Surface::present() const
     {
-        wgpuBufferUnmap(m_handle);
+        wgpuSurfacePresent(m_handle);
     }
 
-    CommandBuffer::CommandBuffer(const WGPUCommandBuffer &handle) : m_handle(handle)
+    void Surface::unconfigure() const
     {
+        wgpuSurfaceUnconfigure(m_handle);
+    }
 
+    TextureView Texture::create_view() const
+    {
+        return TextureView{m_handle, wgpuTextureCreateView(m_handle, nullptr)};
     }
 
-    CommandBuffer::~CommandBuffer()
+    TextureView Texture::create_view(const TextureViewDescriptor &descriptor) const
     {
-        if (m_handle != nullptr)
+        const WGPUTextureViewDescriptor wgpu_descriptor
         {
-            wgpuCommandBufferRelease(m_handle);
-        }
+            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
+            .label = descriptor.label.c_str(),
+            .format = static_cast<WGPUTextureFormat>(descriptor.format),
+            .dimension = static_cast<WGPUTextureViewDimension>(descriptor.dimension),
+            .baseMipLevel = descriptor.base_mip_level,
+            .mipLevelCount = descriptor.mip_level_count,
+            .baseArrayLayer = descriptor.base_array_layer,
+            .arrayLayerCount = descriptor.array_layer_count,
+            .aspect = static_cast<WGPUTextureAspect>(descriptor.aspect),
+        };
+
+        return TextureView{m_handle, wgpuTextureCreateView(m_handle, &wgpu_descriptor)};
+    }
+
+    uint32_t Texture::get_depth_or_array_layers() const
+    {
+        return wgpuTextureGetDepthOrArrayLayers(m_handle);
+    }
+
+    TextureDimension Texture::get_dimension() const
+    {
+        return static_cast<TextureDimension>(wgpuTextureGetDimension(m_handle));
+    }
+
+    TextureFormat Texture::get_format() const
+    {
+        return static_cast<TextureFormat>(wgpuTextureGetFormat(m_handle));
+    }
+
+    uint32_t Texture::get_height() const
+    {
+        return wgpuTextureGetHeight(m_handle);
+    }
+
+    uint32_t Texture::get_mip_level_count() const
+    {
+        return wgpuTextureGetMipLevelCount(m_handle);
+    }
+
+    uint32_t Texture::get_sample_count() const
+    {
+        return wgpuTextureGetSampleCount(m_handle);
+    }
+
+    TextureUsageFlags Texture::get_usage() const
+    {
+        return static_cast<TextureUsageFlags>(wgpuTextureGetUsage(m_handle));
+    }
+
+    uint32_t Texture::get_width() const
+    {
+        return wgpuTextureGetWidth(m_handle);
     }
 
-    CommandBuffer::CommandBuffer(const CommandBuffer &other) : m_handle(other.m_handle)
+    TextureView::TextureView(const WGPUTexture &texture, const WGPUTextureView &handle)
+        : Handle(handle), m_texture(texture)
     {
-        if (m_handle != nullptr)
+        if (texture != nullptr)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuCommandBufferReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuCommandBufferAddRef(m_handle);
-#endif
+            HandleTraits<WGPUTexture>::add_ref(texture);
         }
     }
 
-    CommandBuffer::CommandBuffer(CommandBuffer &&other) noexcept
+    FrameArena::FrameArena(const size_t block_size) : m_block_size(block_size)
+    {
+
+    }
+
+    FrameArena & FrameArena::get_thread_local()
     {
-        std::swap(m_handle, other.m_handle);
+        thread_local FrameArena arena;
+        return arena;
     }
 
-    CommandBuffer & CommandBuffer::operator=(const CommandBuffer &other)
+    void * FrameArena::allocate_bytes(const size_t size, const size_t alignment)
     {
-        if (this != &other)
+        while (true)
         {
-            if (m_handle != nullptr)
+            if (m_current_block < m_blocks.size())
             {
-                wgpuCommandBufferRelease(m_handle);
+                const auto &block = m_blocks[m_current_block];
+                const auto base = reinterpret_cast<uintptr_t>(block.data.get());
+                const auto aligned = (base + m_offset + alignment - 1) & ~(alignment - 1);
+                const auto end = aligned - base + size;
+
+                if (end <= block.size)
+                {
+                    m_offset = end;
+                    return reinterpret_cast<void *>(aligned);
+                }
+
+                ++m_current_block;
+                m_offset = 0;
+                continue;
             }
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+            const auto block_size = std::max(m_block_size, size + alignment);
+            m_blocks.push_back({.data = std::make_unique_for_overwrite<std::byte[]>(block_size), .size = block_size});
+            ++m_heap_allocation_count;
+        }
+    }
+
+    void FrameArena::reset()
+    {
+        // Fold overflow blocks into a single block so the next frame fits without growing again.
+        if (m_blocks.size() > 1)
+        {
+            const auto capacity = get_capacity();
+            m_blocks.clear();
+            m_blocks.push_back({.data = std::make_unique_for_overwrite<std::byte[]>(capacity), .size = capacity});
+            ++m_heap_allocation_count;
+        }
+
+        m_current_block = 0;
+        m_offset = 0;
+    }
+
+    size_t FrameArena::get_bytes_used() const
+    {
+        size_t bytes_used = m_offset;
+        for (size_t i = 0; i < m_current_block && i < m_blocks.size(); ++i)
+        {
+            bytes_used += m_blocks[i].size;
+        }
+        return bytes_used;
+    }
+
+    size_t FrameArena::get_capacity() const
+    {
+        size_t capacity = 0;
+        for (const auto &block : m_blocks)
+        {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+    uint64_t FrameArena::get_heap_allocation_count() const
+    {
+        return m_heap_allocation_count;
+    }
+
+    FrameArenaScope::FrameArenaScope(FrameArena &arena)
+        : m_arena(arena), m_marker{.block = arena.m_current_block, .offset = arena.m_offset}
+    {
+
+    }
+
+    FrameArenaScope::~FrameArenaScope()
+    {
+        m_arena.m_current_block = m_marker.block;
+        m_arena.m_offset = m_marker.offset;
+    }
+
+    EventPump::EventPump(const Instance &instance, const Device &device, const std::chrono::nanoseconds poll_interval)
+        : m_instance(instance), m_device(device), m_queue(device.get_queue()), m_poll_interval(poll_interval)
+    {
+        m_thread = std::thread{&EventPump::run, this};
+    }
+
+    EventPump::~EventPump()
+    {
+        stop();
+    }
+
+    void EventPump::notify()
+    {
+        {
+            const std::lock_guard lock{m_mutex};
+            ++m_pending;
+            m_pump_woken = true;
+        }
+        wgpuQueueOnSubmittedWorkDone(m_queue.c_ptr(), on_work_done, this);
+        m_pump_condition.notify_one();
+        m_condition.notify_all();
+    }
+
+    void EventPump::on_work_done(WGPUQueueWorkDoneStatus, void *user_data)
+    {
+        // Any status means the queue has nothing more to deliver for this notify().
+        auto &pump = *static_cast<EventPump *>(user_data);
+        const std::lock_guard lock{pump.m_mutex};
+        --pump.m_pending;
+    }
+
+    void EventPump::stop()
+    {
+        {
+            const std::lock_guard lock{m_mutex};
+            m_stop_requested = true;
+            m_pump_woken = true;
+        }
+        m_pump_condition.notify_one();
+
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void EventPump::run()
+    {
+        while (true)
+        {
             {
+                std::unique_lock lock{m_mutex};
+                m_pump_condition.wait(lock, [this]
+                {
+                    return m_pending > 0 || m_waiter_count > 0 || m_stop_requested;
+                });
+
+                if (m_stop_requested && m_pending == 0)
+                {
+                    return;
+                }
+            }
+
 #ifdef WEBGPU_BACKEND_WGPU
-                wgpuCommandBufferReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuCommandBufferAddRef(m_handle);
+            // Blocks until all submitted work has finished, and returns true if nothing was left to wait on.
+            const auto idle = wgpuDevicePoll(m_device.c_ptr(), true, nullptr);
+#else
+            m_instance.process_events();
+            m_device.tick();
+            constexpr bool idle = true;
 #endif
+
+            std::unique_lock lock{m_mutex};
+            m_condition.notify_all();
+
+            // Nothing new can be finished until the GPU makes progress, so wait an interval before polling again.
+            if (idle && (m_pending > 0 || m_waiter_count > 0))
+            {
+                m_pump_condition.wait_for(lock, m_poll_interval, [this] { return m_pump_woken; });
             }
+            m_pump_woken = false;
+        }
+    }
+
+    ThreadPool::ThreadPool() : ThreadPool(std::max(std::thread::hardware_concurrency(), 1u) - 1)
+    {
+    }
+
+    ThreadPool::ThreadPool(const size_t worker_count)
+    {
+        m_workers.reserve(worker_count);
+        for (size_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back([this] { run_worker(); });
         }
-        return *this;
     }
 
-    CommandBuffer & CommandBuffer::operator=(CommandBuffer &&other) noexcept
+    ThreadPool::~ThreadPool()
     {
-        if (this != &other)
         {
-            std::swap(m_handle, other.m_handle);
+            const std::lock_guard lock{m_mutex};
+            m_stop_requested = true;
+        }
+        m_work_condition.notify_all();
+
+        for (auto &worker : m_workers)
+        {
+            worker.join();
         }
-        return *this;
     }
 
-    WGPUCommandBuffer CommandBuffer::c_ptr() const
+    size_t ThreadPool::get_worker_count() const
     {
-        return m_handle;
+        return m_workers.size();
     }
 
-    CommandEncoder::CommandEncoder(const WGPUCommandEncoder &handle) : m_handle(handle)
+    void ThreadPool::dispatch(const size_t count, InlineFunction<void(size_t)> &&body)
     {
+        const std::lock_guard dispatch_lock{m_dispatch_mutex};
 
+        {
+            const std::lock_guard lock{m_mutex};
+            m_body = &body;
+            m_count = count;
+            m_next_index.store(0, std::memory_order_relaxed);
+            m_busy_worker_count = m_workers.size();
+            ++m_generation;
+        }
+        m_work_condition.notify_all();
+
+        run_indices();
+
+        // Every worker takes part in every generation, so none can still be reading m_body once this returns.
+        std::unique_lock lock{m_mutex};
+        m_done_condition.wait(lock, [this] { return m_busy_worker_count == 0; });
+        m_body = nullptr;
     }
 
-    CommandEncoder::~CommandEncoder()
+    void ThreadPool::run_indices()
     {
-        if (m_handle != nullptr)
+        for (auto index = m_next_index.fetch_add(1, std::memory_order_relaxed); index < m_count;
+            index = m_next_index.fetch_add(1, std::memory_order_relaxed))
         {
-            wgpuCommandEncoderRelease(m_handle);
+            (*m_body)(index);
         }
     }
 
-    CommandEncoder::CommandEncoder(const CommandEncoder &other) : m_handle(other.m_handle)
+    void ThreadPool::run_worker()
     {
-        if (m_handle != nullptr)
+        uint64_t generation = 0;
+
+        while (true)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuCommandEncoderReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuCommandEncoderAddRef(m_handle);
-#endif
+            {
+                std::unique_lock lock{m_mutex};
+                m_work_condition.wait(lock, [&] { return m_stop_requested || m_generation != generation; });
+
+                if (m_stop_requested)
+                {
+                    return;
+                }
+                generation = m_generation;
+            }
+
+            run_indices();
+
+            const std::lock_guard lock{m_mutex};
+            if (--m_busy_worker_count == 0)
+            {
+                m_done_condition.notify_one();
+            }
+        }
+    }
+
+    ParallelRecorder::ParallelRecorder(const Device &device, ThreadPool &pool) : m_device(device), m_pool(pool)
+    {
+    }
+
+    void ParallelRecorder::submit(const Queue &queue)
+    {
+        queue.submit(m_command_buffers);
+        m_command_buffers.clear();
+    }
+
+    uint64_t ParallelRecorder::submit(FenceTracker &fence_tracker)
+    {
+        const auto serial = fence_tracker.submit(m_command_buffers);
+        m_command_buffers.clear();
+        return serial;
+    }
+
+    std::span<const CommandBuffer> ParallelRecorder::get_command_buffers() const
+    {
+        return m_command_buffers;
+    }
+
+    RenderPipelineCache::RenderPipelineCache(const Device &device, const size_t capacity)
+        : m_device(device), m_capacity(capacity)
+    {
+    }
+
+    RenderPipeline RenderPipelineCache::create_render_pipeline(const RenderPipelineDescriptor &descriptor)
+    {
+        m_key.clear();
+        append_key(m_key, descriptor);
+
+        if (const auto it = m_entries.find(m_key); it != m_entries.end())
+        {
+            ++m_hit_count;
+            m_recency.splice(m_recency.begin(), m_recency, it->second.recency);
+            return it->second.pipeline;
+        }
+
+        ++m_miss_count;
+        if (m_capacity > 0 && m_entries.size() >= m_capacity)
+        {
+            m_entries.erase(*m_recency.back());
+            m_recency.pop_back();
         }
+
+        const auto it = m_entries.emplace(m_key, Entry
+        {
+            .pipeline = m_device.create_render_pipeline(descriptor),
+            .layout = retain(descriptor.layout),
+            .vertex_module = retain(descriptor.vertex.module),
+            .fragment_module = descriptor.fragment ? retain(descriptor.fragment->module) : ShaderModule{},
+        }).first;
+        m_recency.push_front(&it->first);
+        it->second.recency = m_recency.begin();
+
+        return it->second.pipeline;
+    }
+
+    void RenderPipelineCache::clear()
+    {
+        m_recency.clear();
+        m_entries.clear();
+    }
+
+    size_t RenderPipelineCache::get_capacity() const
+    {
+        return m_capacity;
+    }
+
+    uint64_t RenderPipelineCache::get_hit_count() const
+    {
+        return m_hit_count;
+    }
+
+    uint64_t RenderPipelineCache::get_miss_count() const
+    {
+        return m_miss_count;
+    }
+
+    size_t RenderPipelineCache::get_size() const
+    {
+        return m_entries.size();
     }
 
-    CommandEncoder::CommandEncoder(CommandEncoder &&other) noexcept
+    ResourceRegistry::ResourceRegistry(const Device &device) : m_device(device)
     {
-        std::swap(m_handle, other.m_handle);
     }
 
-    CommandEncoder & CommandEncoder::operator=(const CommandEncoder &other)
+    Tracked<BindGroup> ResourceRegistry::create_bind_group(const BindGroupDescriptor &descriptor)
     {
-        if (this != &other)
+        auto record = std::make_shared<BindGroupRecord>(descriptor);
+        if (!find_reference(descriptor.layout.c_ptr(), record->layout.record))
         {
-            if (m_handle != nullptr)
-            {
-                wgpuCommandEncoderRelease(m_handle);
-            }
-
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+            return {};
+        }
+        for (const auto &entry : descriptor.entries)
+        {
+            auto &references = record->entries.emplace_back();
+            if (!find_reference(entry.buffer.c_ptr(), references.buffer.record)
+                || !find_reference(entry.sampler.c_ptr(), references.sampler.record)
+                || !find_reference(entry.texture_view.c_ptr(), references.texture_view.record))
             {
-#ifdef WEBGPU_BACKEND_WGPU
-                wgpuCommandEncoderReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuCommandEncoderAddRef(m_handle);
-#endif
+                return {};
             }
         }
-        return *this;
+        return track<BindGroup>(std::move(record), Dependent);
     }
 
-    CommandEncoder & CommandEncoder::operator=(CommandEncoder &&other) noexcept
+    Tracked<BindGroupLayout> ResourceRegistry::create_bind_group_layout(const BindGroupLayoutDescriptor &descriptor)
     {
-        if (this != &other)
-        {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+        return track<BindGroupLayout>(std::make_shared<BindGroupLayoutRecord>(descriptor), Independent);
     }
 
-    WGPUCommandEncoder CommandEncoder::c_ptr() const
+    Tracked<Buffer> ResourceRegistry::create_buffer(const BufferDescriptor &descriptor)
     {
-        return m_handle;
+        const auto record = std::make_shared<BufferRecord>(descriptor);
+        auto buffer = track<Buffer>(record, Independent);
+        record->descriptor.mapped_at_creation = false;
+        return buffer;
     }
 
-    RenderPassEncoder CommandEncoder::begin_render_pass(const RenderPassDescriptor &descriptor) const
+    Tracked<ComputePipeline> ResourceRegistry::create_compute_pipeline(const ComputePipelineDescriptor &descriptor)
     {
-        std::vector<WGPURenderPassColorAttachment> wgpu_color_attachments;
-        wgpu_color_attachments.reserve(descriptor.color_attachments.size());
-        for (const auto &color_attachment : descriptor.color_attachments)
+        auto record = std::make_shared<ComputePipelineRecord>(descriptor);
+        if (!find_reference(descriptor.layout.c_ptr(), record->layout.record)
+            || !find_reference(descriptor.compute.module.c_ptr(), record->module.record))
         {
-            wgpu_color_attachments.push_back(
-            {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(color_attachment.next_in_chain),
-                .view = color_attachment.view ? color_attachment.view->c_ptr() : nullptr,
-#ifdef WEBGPU_BACKEND_DAWN
-                .depthSlice = color_attachment.depth_slice,
-#endif
-                .resolveTarget = color_attachment.resolve_target ? color_attachment.resolve_target->c_ptr() : nullptr,
-                .loadOp = static_cast<WGPULoadOp>(color_attachment.load_op),
-                .storeOp = static_cast<WGPUStoreOp>(color_attachment.store_op),
-                .clearValue = *reinterpret_cast<const WGPUColor*>(&color_attachment.clear_value),
-            });
+            return {};
         }
+        return track<ComputePipeline>(std::move(record), Dependent);
+    }
 
-        WGPURenderPassDepthStencilAttachment wgpu_depth_stencil_attachment{};
-        if (descriptor.depth_stencil_attachment)
+    Tracked<PipelineLayout> ResourceRegistry::create_pipeline_layout(const PipelineLayoutDescriptor &descriptor)
+    {
+        auto record = std::make_shared<PipelineLayoutRecord>(descriptor);
+        for (const auto &layout : descriptor.bind_group_layouts)
         {
-            wgpu_depth_stencil_attachment = WGPURenderPassDepthStencilAttachment
+            if (!find_reference(layout.c_ptr(), record->bind_group_layouts.emplace_back().record))
             {
-                .view = descriptor.depth_stencil_attachment->view.c_ptr(),
-                .depthLoadOp = static_cast<WGPULoadOp>(descriptor.depth_stencil_attachment->depth_load_op),
-                .depthStoreOp = static_cast<WGPUStoreOp>(descriptor.depth_stencil_attachment->depth_store_op),
-                .depthClearValue = descriptor.depth_stencil_attachment->depth_clear_value,
-                .stencilLoadOp = static_cast<WGPULoadOp>(descriptor.depth_stencil_attachment->stencil_load_op),
-                .stencilStoreOp = static_cast<WGPUStoreOp>(descriptor.depth_stencil_attachment->stencil_store_op),
-                .stencilClearValue = descriptor.depth_stencil_attachment->stencil_clear_value,
-                .stencilReadOnly = descriptor.depth_stencil_attachment->stencil_read_only,
-            };
+                return {};
+            }
         }
+        return track<PipelineLayout>(std::move(record), Intermediate);
+    }
 
-        const WGPURenderPassDescriptor wgpu_descriptor
+    Tracked<RenderPipeline> ResourceRegistry::create_render_pipeline(const RenderPipelineDescriptor &descriptor)
+    {
+        auto record = std::make_shared<RenderPipelineRecord>(descriptor);
+        if (!find_reference(descriptor.layout.c_ptr(), record->layout.record)
+            || !find_reference(descriptor.vertex.module.c_ptr(), record->vertex_module.record)
+            || (descriptor.fragment
+                && !find_reference(descriptor.fragment->module.c_ptr(), record->fragment_module.record)))
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .colorAttachmentCount = wgpu_color_attachments.size(),
-            .colorAttachments = wgpu_color_attachments.data(),
-            .depthStencilAttachment = descriptor.depth_stencil_attachment ? &wgpu_depth_stencil_attachment : nullptr,
-            .occlusionQuerySet = nullptr,
-            .timestampWrites = nullptr,
-        };
-
-        return RenderPassEncoder{wgpuCommandEncoderBeginRenderPass(m_handle, &wgpu_descriptor)};
+            return {};
+        }
+        return track<RenderPipeline>(std::move(record), Dependent);
     }
 
-    void CommandEncoder::copy_buffer_to_buffer(const Buffer &source, const uint64_t source_offset,
-        const Buffer &destination, const uint64_t destination_offset, const uint64_t size) const
+    Tracked<Sampler> ResourceRegistry::create_sampler(const SamplerDescriptor &descriptor)
     {
-        wgpuCommandEncoderCopyBufferToBuffer(
-            m_handle,
-            source.c_ptr(), source_offset,
-            destination.c_ptr(), destination_offset,
-            size
-        );
+        return track<Sampler>(std::make_shared<SamplerRecord>(descriptor), Independent);
     }
 
-
-    CommandBuffer CommandEncoder::finish(const CommandBufferDescriptor &descriptor) const
+    Tracked<ShaderModule> ResourceRegistry::create_shader_module(const ShaderModuleDescriptor &descriptor)
     {
-        const WGPUCommandBufferDescriptor wgpu_descriptor
-        {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-        };
-
-        return CommandBuffer{wgpuCommandEncoderFinish(m_handle, &wgpu_descriptor)};
+        return track<ShaderModule>(std::make_shared<ShaderModuleRecord>(descriptor), Independent);
     }
 
-    Device::Device(const WGPUDevice &handle) : m_handle(handle)
+    Tracked<Texture> ResourceRegistry::create_texture(const TextureDescriptor &descriptor)
     {
+        return track<Texture>(std::make_shared<TextureRecord>(descriptor), Independent);
+    }
 
+    Tracked<TextureView> ResourceRegistry::create_texture_view(const Tracked<Texture> &texture)
+    {
+        auto record = std::make_shared<TextureViewRecord>();
+        record->texture = texture.m_record;
+        return track<TextureView>(std::move(record), Intermediate);
     }
 
-    Device::~Device()
+    Tracked<TextureView> ResourceRegistry::create_texture_view(const Tracked<Texture> &texture,
+        const TextureViewDescriptor &descriptor)
     {
-        if (m_handle != nullptr)
-        {
-            wgpuDeviceRelease(m_handle);
-        }
+        auto record = std::make_shared<TextureViewRecord>();
+        record->texture = texture.m_record;
+        record->descriptor = descriptor;
+        own_label(record->descriptor->label, record->label);
+        return track<TextureView>(std::move(record), Intermediate);
     }
 
-    Device::Device(const Device &other) : m_handle(other.m_handle)
+    std::chrono::nanoseconds ResourceRegistry::rebuild(const Device &device)
     {
-        if (m_handle != nullptr)
+        const auto start = std::chrono::steady_clock::now();
+
+        m_device = device;
+        m_records_by_handle.clear();
+
+        for (auto &stage : m_stages)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuDeviceReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuDeviceAddRef(m_handle);
-#endif
+            std::erase_if(stage, [](const auto &record) { return record.expired(); });
+            for (const auto &weak_record : stage)
+            {
+                if (const auto record = weak_record.lock())
+                {
+                    record->recreate(m_device);
+                    m_records_by_handle[record->get_c_handle()] = record;
+                }
+            }
         }
+
+        return std::chrono::steady_clock::now() - start;
     }
 
-    Device::Device(Device &&other) noexcept
+    const Device & ResourceRegistry::get_device() const
     {
-        std::swap(m_handle, other.m_handle);
+        return m_device;
     }
 
-    Device & Device::operator=(const Device &other)
+    size_t ResourceRegistry::get_resource_count() const
     {
-        if (this != &other)
+        size_t count = 0;
+        for (const auto &stage : m_stages)
         {
-            if (m_handle != nullptr)
-            {
-                wgpuDeviceRelease(m_handle);
-            }
-
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
-            {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuDeviceReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuDeviceAddRef(m_handle);
-#endif
-            }
+            count += std::ranges::count_if(stage, [](const auto &record) { return !record.expired(); });
         }
-        return *this;
+        return count;
     }
 
-    Device & Device::operator=(Device &&other) noexcept
+    template<typename T, typename Record>
+    Tracked<T> ResourceRegistry::track(std::shared_ptr<Record> record, const Stage stage)
     {
-        if (this != &other)
+        record->recreate(m_device);
+        m_stages[stage].push_back(record);
+        m_records_by_handle[record->get_c_handle()] = record;
+
+        // Released resources leave expired entries behind, so sweep them whenever the registry has doubled.
+        if (m_records_by_handle.size() >= m_next_collection_size)
         {
-            std::swap(m_handle, other.m_handle);
+            collect_expired();
         }
-        return *this;
-    }
 
-    WGPUDevice Device::c_ptr() const
-    {
-        return m_handle;
+        const T *handle = &record->handle;
+        return Tracked<T>{std::move(record), handle};
     }
 
-    BindGroup Device::create_bind_group(const BindGroupDescriptor &descriptor) const
+    std::shared_ptr<detail::TrackedRecord> ResourceRegistry::find_record(const void *handle)
     {
-        std::vector<WGPUBindGroupEntry> wgpu_entries;
-        wgpu_entries.reserve(descriptor.entries.size());
-        for (const BindGroupEntry &entry : descriptor.entries)
+        if (handle == nullptr)
         {
-            wgpu_entries.push_back(WGPUBindGroupEntry
-            {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.next_in_chain),
-                .binding = entry.binding,
-                .buffer = entry.buffer ? entry.buffer->c_ptr() : nullptr,
-                .offset = entry.offset,
-                .size = entry.size,
-                .sampler = entry.sampler ? entry.sampler->c_ptr() : nullptr,
-                .textureView = entry.texture_view ? entry.texture_view->c_ptr() : nullptr,
-            });
+            return nullptr;
         }
 
-        const WGPUBindGroupDescriptor wgpu_descriptor
+        const auto it = m_records_by_handle.find(handle);
+        if (it == m_records_by_handle.end())
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .layout = descriptor.layout.c_ptr(),
-            .entryCount = wgpu_entries.size(),
-            .entries = wgpu_entries.data(),
-        };
+            return nullptr;
+        }
+        return it->second.lock();
+    }
 
-        return BindGroup{wgpuDeviceCreateBindGroup(m_handle, &wgpu_descriptor)};
+    bool ResourceRegistry::find_reference(const void *handle, std::shared_ptr<detail::TrackedRecord> &record)
+    {
+        record = find_record(handle);
+        return handle == nullptr || record != nullptr;
     }
 
-    BindGroupLayout Device::create_bind_group_layout(const BindGroupLayoutDescriptor &descriptor) const
+    void ResourceRegistry::collect_expired()
     {
-        std::vector<WGPUBindGroupLayoutEntry> wgpu_entries;
-        wgpu_entries.reserve(descriptor.entries.size());
-        for (const BindGroupLayoutEntry &entry : descriptor.entries)
+        for (auto &stage : m_stages)
         {
-            wgpu_entries.push_back(WGPUBindGroupLayoutEntry
-            {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.next_in_chain),
-                .binding = entry.binding,
-                .visibility = static_cast<WGPUShaderStageFlags>(entry.visibility),
-                .buffer = WGPUBufferBindingLayout
-                {
-                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.buffer.next_in_chain),
-                    .type = static_cast<WGPUBufferBindingType>(entry.buffer.type),
-                    .hasDynamicOffset = entry.buffer.has_dynamic_offset,
-                    .minBindingSize = entry.buffer.min_binding_size,
-                },
-                .sampler = WGPUSamplerBindingLayout
-                {
-                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.sampler.next_in_chain),
-                    .type = static_cast<WGPUSamplerBindingType>(entry.sampler.type),
-                },
-                .texture = WGPUTextureBindingLayout
-                {
-                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.texture.next_in_chain),
-                    .sampleType = static_cast<WGPUTextureSampleType>(entry.texture.sample_type),
-                    .viewDimension = static_cast<WGPUTextureViewDimension>(entry.texture.view_dimension),
-                    .multisampled = entry.texture.multisampled,
-                },
-                .storageTexture = WGPUStorageTextureBindingLayout
-                {
-                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(entry.storage_texture.next_in_chain),
-                    .access = static_cast<WGPUStorageTextureAccess>(entry.storage_texture.access),
-                    .format = static_cast<WGPUTextureFormat>(entry.storage_texture.format),
-                    .viewDimension = static_cast<WGPUTextureViewDimension>(entry.storage_texture.view_dimension),
-                },
-            });
+            std::erase_if(stage, [](const auto &record) { return record.expired(); });
         }
+        std::erase_if(m_records_by_handle, [](const auto &entry) { return entry.second.expired(); });
 
-        const WGPUBindGroupLayoutDescriptor wgpu_descriptor
-        {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .entryCount = wgpu_entries.size(),
-            .entries = wgpu_entries.data(),
-        };
-
-        return BindGroupLayout{wgpuDeviceCreateBindGroupLayout(m_handle, &wgpu_descriptor)};
+        m_next_collection_size = std::max<size_t>(m_records_by_handle.size() * 2, 64);
     }
 
-    Buffer Device::create_buffer(const BufferDescriptor &descriptor) const
+    StagingBelt::StagingBelt(const Device &device, const uint64_t chunk_size)
+        : m_device(device), m_chunk_size((chunk_size + 7) & ~uint64_t{7})
     {
-        const WGPUBufferDescriptor wgpu_descriptor
-        {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .usage = static_cast<WGPUBufferUsageFlags>(descriptor.usage),
-            .size = descriptor.size,
-            .mappedAtCreation = descriptor.mapped_at_creation,
-        };
-
-        return Buffer{wgpuDeviceCreateBuffer(m_handle, &wgpu_descriptor)};
     }
 
-    CommandEncoder Device::create_command_encoder(const CommandEncoderDescriptor &descriptor) const
+    std::span<std::byte> StagingBelt::write_buffer(const CommandEncoder &encoder, const Buffer &destination,
+        const uint64_t offset, const uint64_t size)
     {
-        const WGPUCommandEncoderDescriptor wgpu_descriptor
-        {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-        };
+        auto &chunk = get_chunk(size);
+        const auto chunk_offset = chunk.offset;
 
-        return CommandEncoder{wgpuDeviceCreateCommandEncoder(m_handle, &wgpu_descriptor)};
+        // Mapped ranges have to start on an 8-byte boundary.
+        chunk.offset = (chunk.offset + size + 7) & ~uint64_t{7};
+
+        encoder.copy_buffer_to_buffer(chunk.buffer, chunk_offset, destination, offset, size);
+        return {chunk.buffer.get_mapped_range<std::byte>(chunk_offset, size), size};
     }
 
-    PipelineLayout Device::create_pipeline_layout(const PipelineLayoutDescriptor &descriptor) const
+    void StagingBelt::finish()
     {
-        std::vector<WGPUBindGroupLayout> wgpu_bind_group_layouts;
-        wgpu_bind_group_layouts.reserve(descriptor.bind_group_layouts.size());
-        for (const auto &bind_group_layout : descriptor.bind_group_layouts)
+        for (auto &chunk : m_active_chunks)
         {
-            wgpu_bind_group_layouts.push_back(bind_group_layout.c_ptr());
+            chunk.buffer.unmap();
+            m_closed_chunks.push_back(std::move(chunk));
         }
+        m_active_chunks.clear();
+    }
 
-        const WGPUPipelineLayoutDescriptor wgpu_descriptor
+    void StagingBelt::recall()
+    {
+        for (auto &chunk : m_closed_chunks)
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .bindGroupLayoutCount = wgpu_bind_group_layouts.size(),
-            .bindGroupLayouts = wgpu_bind_group_layouts.data(),
-        };
+            // Dedicated chunks for oversized uploads are released, so one large upload does not pin its memory.
+            if (chunk.size > m_chunk_size)
+            {
+                continue;
+            }
+            chunk.offset = 0;
 
-        return PipelineLayout{wgpuDeviceCreatePipelineLayout(m_handle, &wgpu_descriptor)};
+            // A chunk whose mapping fails, such as after a device loss, is dropped rather than reused.
+            const auto buffer = chunk.buffer;
+            buffer.map_async(MapModeFlags::Write, 0, chunk.size,
+                [free_chunks = m_free_chunks, chunk = std::move(chunk)](const BufferMapAsyncStatus status) mutable
+                {
+                    if (status == BufferMapAsyncStatus::Success)
+                    {
+                        const std::lock_guard lock{free_chunks->mutex};
+                        free_chunks->chunks.push_back(std::move(chunk));
+                    }
+                });
+        }
+        m_closed_chunks.clear();
     }
 
-    RenderPipeline Device::create_render_pipeline(const RenderPipelineDescriptor &descriptor) const
+    uint64_t StagingBelt::get_chunk_size() const
+    {
+        return m_chunk_size;
+    }
+
+    StagingBelt::Chunk & StagingBelt::get_chunk(const uint64_t size)
     {
-        std::vector<WGPUConstantEntry> wgpu_vertex_constants;
-        wgpu_vertex_constants.reserve(descriptor.vertex.constants.size());
-        for (const auto &constant : descriptor.vertex.constants)
+        for (auto &chunk : m_active_chunks)
         {
-            wgpu_vertex_constants.push_back({
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(constant.next_in_chain),
-                .key = constant.key.c_str(),
-                .value = constant.value,
-            });
+            if (chunk.offset + size <= chunk.size)
+            {
+                return chunk;
+            }
         }
 
-        std::vector<WGPUVertexBufferLayout> wgpu_vertex_buffers;
-        wgpu_vertex_buffers.reserve(descriptor.vertex.buffers.size());
-        std::vector<std::vector<WGPUVertexAttribute>> wgpu_vertex_buffers_attributes(descriptor.vertex.buffers.size());
-        for (auto i = 0; i < descriptor.vertex.buffers.size(); ++i)
         {
-            const auto &buffer = descriptor.vertex.buffers[i];
-            auto &wgpu_vertex_buffer_attributes = wgpu_vertex_buffers_attributes[i];
+            const std::lock_guard lock{m_free_chunks->mutex};
+            auto &free_chunks = m_free_chunks->chunks;
 
-            wgpu_vertex_buffer_attributes.reserve(buffer.attributes.size());
-            for (const auto &attribute : buffer.attributes)
+            // Best fit, so small uploads leave larger chunks for the uploads that need them.
+            auto it = free_chunks.end();
+            for (auto candidate = free_chunks.begin(); candidate != free_chunks.end(); ++candidate)
             {
-                wgpu_vertex_buffer_attributes.push_back(
+                if (candidate->size >= size && (it == free_chunks.end() || candidate->size < it->size))
                 {
-                    .format = static_cast<WGPUVertexFormat>(attribute.format),
-                    .offset = attribute.offset,
-                    .shaderLocation = attribute.shader_location,
-                });
+                    it = candidate;
+                }
             }
-
-            wgpu_vertex_buffers.push_back(
+            if (it != free_chunks.end())
             {
-                .arrayStride = buffer.array_stride,
-                .stepMode = static_cast<WGPUVertexStepMode>(buffer.step_mode),
-                .attributeCount = wgpu_vertex_buffer_attributes.size(),
-                .attributes = wgpu_vertex_buffer_attributes.data(),
-            });
+                m_active_chunks.push_back(std::move(*it));
+                free_chunks.erase(it);
+                return m_active_chunks.back();
+            }
         }
 
-        std::optional<WGPUDepthStencilState> wgpu_depth_stencil;
-        if (descriptor.depth_stencil)
+        // Uploads larger than a chunk get a chunk of their own, which recall releases instead of recycling.
+        const auto chunk_size = std::max(m_chunk_size, (size + 7) & ~uint64_t{7});
+        m_active_chunks.push_back(Chunk
         {
-            wgpu_depth_stencil = WGPUDepthStencilState
+            .buffer = m_device.create_buffer(BufferDescriptor
             {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.depth_stencil->next_in_chain),
-                .format = static_cast<WGPUTextureFormat>(descriptor.depth_stencil->format),
-                .depthWriteEnabled = descriptor.depth_stencil->depth_write_enabled,
-                .depthCompare = static_cast<WGPUCompareFunction>(descriptor.depth_stencil->depth_compare),
-                .stencilFront = WGPUStencilFaceState
-                {
-                    .compare = static_cast<WGPUCompareFunction>(descriptor.depth_stencil->stencil_front.compare),
-                    .failOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_front.fail_op),
-                    .depthFailOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_front.depth_fail_op),
-                    .passOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_front.pass_op),
-                },
-                .stencilBack = WGPUStencilFaceState
-                {
-                    .compare = static_cast<WGPUCompareFunction>(descriptor.depth_stencil->stencil_back.compare),
-                    .failOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_back.fail_op),
-                    .depthFailOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_back.depth_fail_op),
-                    .passOp = static_cast<WGPUStencilOperation>(descriptor.depth_stencil->stencil_back.pass_op),
-                },
-                .stencilReadMask = descriptor.depth_stencil->stencil_read_mask,
-                .stencilWriteMask = descriptor.depth_stencil->stencil_write_mask,
-                .depthBias = descriptor.depth_stencil->depth_bias,
-                .depthBiasSlopeScale = descriptor.depth_stencil->depth_bias_slope_scale,
-                .depthBiasClamp = descriptor.depth_stencil->depth_bias_clamp,
-            };
-        }
+                .label = "Staging belt chunk",
+                .usage = BufferUsageFlags::MapWrite | BufferUsageFlags::CopySrc,
+                .size = chunk_size,
+                .mapped_at_creation = true,
+            }),
+            .size = chunk_size,
+            .offset = 0,
+        });
+        return m_active_chunks.back();
+    }
+
+    TexturePool::TexturePool(const Device &device, const FenceTracker &fence_tracker, const uint32_t max_idle_frames)
+        : m_device(device), m_fence_tracker(fence_tracker), m_max_idle_frames(max_idle_frames)
+    {
+    }
 
-        // We need to keep all of these in scope until the end of the function.
-        std::optional<WGPUFragmentState> wgpu_fragment;
-        std::vector<WGPUConstantEntry> wgpu_fragment_constants;
-        std::vector<WGPUColorTargetState> wgpu_fragment_targets;
-        std::optional<WGPUBlendState> wgpu_fragment_target_blend;
-        if (descriptor.fragment)
+    Texture TexturePool::acquire(const TextureDescriptor &descriptor)
+    {
+        Key key
         {
-            wgpu_fragment_constants.reserve(descriptor.fragment->constants.size());
-            for (const auto &constant : descriptor.fragment->constants)
-            {
-                wgpu_fragment_constants.push_back(
-                {
-                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(constant.next_in_chain),
-                    .key = constant.key.c_str(),
-                    .value = constant.value,
-                });
-            }
+            .usage = descriptor.usage,
+            .dimension = descriptor.dimension,
+            .width = descriptor.size.width,
+            .height = descriptor.size.height,
+            .depth_or_array_layers = descriptor.size.depth_or_array_layers,
+            .format = descriptor.format,
+            .mip_level_count = descriptor.mip_level_count,
+            .sample_count = descriptor.sample_count,
+            .view_formats = descriptor.view_formats,
+        };
 
-            wgpu_fragment_targets.reserve(descriptor.fragment->targets.size());
-            for (const auto &target : descriptor.fragment->targets)
+        if (const auto it = m_idle_textures.find(key); it != m_idle_textures.end())
+        {
+            // Textures are appended as they are released, so the ones most likely to be complete come first.
+            auto &idle_textures = it->second;
+            const auto ready = std::ranges::find_if(idle_textures, [this](const IdleTexture &idle_texture)
             {
-                if (target.blend)
-                {
-                    wgpu_fragment_target_blend = WGPUBlendState
-                    {
-                        .color = WGPUBlendComponent
-                        {
-                            .operation = static_cast<WGPUBlendOperation>(target.blend->color.operation),
-                            .srcFactor = static_cast<WGPUBlendFactor>(target.blend->color.src_factor),
-                            .dstFactor = static_cast<WGPUBlendFactor>(target.blend->color.dst_factor),
-                        },
-                        .alpha = WGPUBlendComponent
-                        {
-                            .operation = static_cast<WGPUBlendOperation>(target.blend->alpha.operation),
-                            .srcFactor = static_cast<WGPUBlendFactor>(target.blend->alpha.src_factor),
-                            .dstFactor = static_cast<WGPUBlendFactor>(target.blend->alpha.dst_factor),
-                        }
-                    };
-                }
-
-                wgpu_fragment_targets.push_back(
-                {
-                    .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(target.next_in_chain),
-                    .format = static_cast<WGPUTextureFormat>(target.format),
-                    .blend = wgpu_fragment_target_blend ? &wgpu_fragment_target_blend.value() : nullptr,
-                    .writeMask = static_cast<WGPUColorWriteMaskFlags>(target.write_mask),
-                });
-            }
+                return m_fence_tracker.is_complete(idle_texture.last_use_serial);
+            });
 
-            wgpu_fragment = WGPUFragmentState
+            if (ready != idle_textures.end())
             {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.fragment->next_in_chain),
-                .module = descriptor.fragment->module.c_ptr(),
-                .entryPoint = descriptor.fragment->entry_point ? descriptor.fragment->entry_point->c_str() : nullptr,
-                .constantCount = wgpu_fragment_constants.size(),
-                .constants = wgpu_fragment_constants.data(),
-                .targetCount = wgpu_fragment_targets.size(),
-                .targets = wgpu_fragment_targets.data(),
-            };
+                auto texture = std::move(ready->texture);
+                idle_textures.erase(ready);
+                m_acquired_textures.emplace(texture.c_ptr(), AcquiredTexture{texture, std::move(key)});
+                return texture;
+            }
         }
 
-        const WGPURenderPipelineDescriptor wgpu_descriptor
+        auto texture = m_device.create_texture(descriptor);
+        ++m_created_count;
+        m_acquired_textures.emplace(texture.c_ptr(), AcquiredTexture{texture, std::move(key)});
+        return texture;
+    }
+
+    void TexturePool::release(const Texture &texture)
+    {
+        release(texture, m_fence_tracker.get_last_submitted_serial() + 1);
+    }
+
+    void TexturePool::release(const Texture &texture, const uint64_t last_use_serial)
+    {
+        const auto it = m_acquired_textures.find(texture.c_ptr());
+        if (it == m_acquired_textures.end())
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .layout = descriptor.layout ? descriptor.layout->c_ptr() : nullptr,
-            .vertex = WGPUVertexState
-            {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.vertex.next_in_chain),
-                .module = descriptor.vertex.module.c_ptr(),
-                .entryPoint = descriptor.vertex.entry_point ? descriptor.vertex.entry_point->c_str() : nullptr,
-                .constantCount = wgpu_vertex_constants.size(),
-                .constants = wgpu_vertex_constants.data(),
-                .bufferCount = wgpu_vertex_buffers.size(),
-                .buffers = wgpu_vertex_buffers.data(),
-            },
-            .primitive = WGPUPrimitiveState
-            {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.primitive.next_in_chain),
-                .topology = static_cast<WGPUPrimitiveTopology>(descriptor.primitive.topology),
-                .stripIndexFormat = static_cast<WGPUIndexFormat>(descriptor.primitive.strip_index_format),
-                .frontFace = static_cast<WGPUFrontFace>(descriptor.primitive.front_face),
-                .cullMode = static_cast<WGPUCullMode>(descriptor.primitive.cull_mode),
-            },
-            .depthStencil = wgpu_depth_stencil ? &wgpu_depth_stencil.value() : nullptr,
-            .multisample = WGPUMultisampleState
-            {
-                .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.multisample.next_in_chain),
-                .count = descriptor.multisample.count,
-                .mask = descriptor.multisample.mask,
-                .alphaToCoverageEnabled = descriptor.multisample.alpha_to_coverage_enabled,
-            },
-            .fragment = wgpu_fragment ? &wgpu_fragment.value() : nullptr,
-        };
+            return;
+        }
 
-        return RenderPipeline{wgpuDeviceCreateRenderPipeline(m_handle, &wgpu_descriptor)};
+        auto node = m_acquired_textures.extract(it);
+        m_idle_textures[std::move(node.mapped().key)].push_back(IdleTexture
+        {
+            .texture = std::move(node.mapped().texture),
+            .last_use_serial = last_use_serial,
+            .released_frame = m_frame,
+        });
     }
 
-    Sampler Device::create_sampler(const SamplerDescriptor &descriptor) const
+    void TexturePool::end_frame()
     {
-        const WGPUSamplerDescriptor wgpu_sampler_descriptor
+        ++m_frame;
+
+        for (auto it = m_idle_textures.begin(); it != m_idle_textures.end();)
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .addressModeU = static_cast<WGPUAddressMode>(descriptor.address_mode_u),
-            .addressModeV = static_cast<WGPUAddressMode>(descriptor.address_mode_v),
-            .addressModeW = static_cast<WGPUAddressMode>(descriptor.address_mode_w),
-            .magFilter = static_cast<WGPUFilterMode>(descriptor.mag_filter),
-            .minFilter = static_cast<WGPUFilterMode>(descriptor.min_filter),
-            .mipmapFilter = static_cast<WGPUMipmapFilterMode>(descriptor.mipmap_filter),
-            .lodMinClamp = descriptor.lod_min_clamp,
-            .lodMaxClamp = descriptor.lod_max_clamp,
-            .compare = static_cast<WGPUCompareFunction>(descriptor.compare),
-            .maxAnisotropy = descriptor.max_anistropy,
-        };
+            std::erase_if(it->second, [this](const IdleTexture &idle_texture)
+            {
+                return m_frame - idle_texture.released_frame >= m_max_idle_frames;
+            });
 
-        return Sampler{wgpuDeviceCreateSampler(m_handle, &wgpu_sampler_descriptor)};
+            it = it->second.empty() ? m_idle_textures.erase(it) : std::next(it);
+        }
     }
 
-    ShaderModule Device::create_shader_module(const ShaderModuleDescriptor &descriptor) const
+    uint64_t TexturePool::get_created_count() const
     {
-        const WGPUShaderModuleDescriptor wgpu_descriptor
-        {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-#ifdef WEBGPU_BACKEND_WGPU
-            .hintCount = 0,
-            .hints = nullptr,
-#endif
-        };
+        return m_created_count;
+    }
 
-        return ShaderModule{wgpuDeviceCreateShaderModule(m_handle, &wgpu_descriptor)};
+    size_t TexturePool::get_idle_count() const
+    {
+        size_t count = 0;
+        for (const auto &[key, idle_textures] : m_idle_textures)
+        {
+            count += idle_textures.size();
+        }
+        return count;
     }
 
-    Texture Device::create_texture(const TextureDescriptor &descriptor) const
+    size_t TexturePool::KeyHash::operator()(const Key &key) const
     {
-        const WGPUTextureDescriptor wgpu_descriptor
+        // FNV-1a, one field at a time.
+        uint64_t hash = 14695981039346656037ull;
+        const auto combine = [&hash](const uint64_t value)
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .usage = static_cast<WGPUTextureUsageFlags>(descriptor.usage),
-            .dimension = static_cast<WGPUTextureDimension>(descriptor.dimension),
-            .size = WGPUExtent3D
-            {
-                .width = descriptor.size.width,
-                .height = descriptor.size.height,
-                .depthOrArrayLayers = descriptor.size.depth_or_array_layers,
-            },
-            .format = static_cast<WGPUTextureFormat>(descriptor.format),
-            .mipLevelCount = descriptor.mip_level_count,
-            .sampleCount = descriptor.sample_count,
-            .viewFormatCount = descriptor.view_formats.size(),
-            .viewFormats = reinterpret_cast<const WGPUTextureFormat *>(descriptor.view_formats.data()),
+            hash = (hash ^ value) * 1099511628211ull;
         };
 
-        return Texture{wgpuDeviceCreateTexture(m_handle, &wgpu_descriptor)};
+        combine(static_cast<uint64_t>(key.usage));
+        combine(static_cast<uint64_t>(key.dimension));
+        combine(key.width);
+        combine(key.height);
+        combine(key.depth_or_array_layers);
+        combine(static_cast<uint64_t>(key.format));
+        combine(key.mip_level_count);
+        combine(key.sample_count);
+        for (const auto format : key.view_formats)
+        {
+            combine(static_cast<uint64_t>(format));
+        }
+
+        return static_cast<size_t>(hash);
     }
 
-    std::optional<SupportedLimits> Device::get_limits() const
+    UniformRing::UniformRing(const Device &device, const uint32_t size)
     {
-        WGPUSupportedLimits wgpu_supported_limits{};
-        const auto result = wgpuDeviceGetLimits(m_handle, &wgpu_supported_limits);
+        // 256 is the default limit, and the most any adapter may require.
+        const auto limits = device.get_limits();
+        m_alignment = limits ? limits->limits.min_uniform_buffer_offset_alignment : 256;
 
-#ifdef WEBGPU_BACKEND_WGPU
-        if (!result)
-#endif
-#ifdef WEBGPU_BACKEND_DAWN
-        if (result != WGPUStatus_Success)
-#endif
+        const auto aligned_size = (size + m_alignment - 1) & ~(m_alignment - 1);
+        m_buffer = device.create_buffer(BufferDescriptor
+        {
+            .label = "Uniform ring",
+            .usage = BufferUsageFlags::CopyDst | BufferUsageFlags::Uniform,
+            .size = aligned_size,
+        });
+        m_data.resize(aligned_size);
+    }
+
+    std::optional<uint32_t> UniformRing::push_bytes(const std::span<const std::byte> data)
+    {
+        if (m_offset > m_data.size() || data.size() > m_data.size() - m_offset)
         {
             return std::nullopt;
         }
 
-        return *reinterpret_cast<SupportedLimits *>(&wgpu_supported_limits);
+        const auto offset = m_offset;
+        std::ranges::copy(data, m_data.begin() + offset);
+
+        m_end = offset + static_cast<uint32_t>(data.size());
+        m_offset = (m_end + m_alignment - 1) & ~(m_alignment - 1);
+        return offset;
     }
 
-    Queue Device::get_queue() const
+    void UniformRing::flush(const Queue &queue)
     {
-        return Queue{wgpuDeviceGetQueue(m_handle)};
+        if (m_end > 0)
+        {
+            // Write sizes must be multiples of 4. The buffer size is a multiple of the alignment, so this stays
+            // in bounds.
+            const auto size = (m_end + 3) & ~3u;
+            queue.write_buffer(m_buffer, 0, std::span{m_data.data(), size});
+        }
+
+        m_offset = 0;
+        m_end = 0;
     }
 
-    void Device::tick() const
+    uint32_t UniformRing::get_alignment() const
     {
-#ifdef WEBGPU_BACKEND_DAWN
-        wgpuDeviceTick(m_handle);
-#endif
+        return m_alignment;
     }
 
-    Instance::Instance(const WGPUInstance &handle) : m_handle(handle)
+    const Buffer & UniformRing::get_buffer() const
     {
+        return m_buffer;
+    }
+
+    uint32_t UniformRing::get_bytes_used() const
+    {
+        return m_end;
+    }
 
+    uint32_t UniformRing::get_size() const
+    {
+        return static_cast<uint32_t>(m_data.size());
     }
 
-    Instance::~Instance()
+    BufferAllocator::BufferAllocator(const Device &device, const BufferUsageFlags usage, const uint64_t page_size)
+        : m_device(device), m_usage(usage), m_page_size(page_size)
     {
-        if (m_handle != nullptr)
+        for (auto &free_lists : m_free_lists)
         {
-            wgpuInstanceRelease(m_handle);
+            free_lists.fill(null_node);
         }
     }
 
-    Instance::Instance(const Instance &other) : m_handle(other.m_handle)
+    std::optional<BufferAllocation> BufferAllocator::allocate(const uint64_t size, const uint64_t alignment)
     {
-        if (m_handle != nullptr)
+        if (size == 0 || !std::has_single_bit(alignment))
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuInstanceReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuInstanceAddRef(m_handle);
-#endif
+            return std::nullopt;
+        }
+
+        // Any range that fits the worst-case padding can be aligned.
+        const auto padded_size = size + alignment - 1;
+        auto node = find_free_node(padded_size);
+        if (node == null_node)
+        {
+            node = add_page(std::max(m_page_size, padded_size));
+        }
+        else
+        {
+            remove_free_node(node);
+        }
+
+        const auto aligned_offset = (m_nodes[node].offset + alignment - 1) & ~(alignment - 1);
+        if (aligned_offset != m_nodes[node].offset)
+        {
+            const auto padding = node;
+            node = split_node(padding, aligned_offset - m_nodes[padding].offset);
+            insert_free_node(padding);
         }
+        if (m_nodes[node].size > size)
+        {
+            insert_free_node(split_node(node, size));
+        }
+
+        m_nodes[node].free = false;
+        m_allocated_bytes += size;
+        ++m_allocation_count;
+
+        return BufferAllocation
+        {
+            .slice = BufferSlice
+            {
+                .buffer = m_pages[m_nodes[node].page],
+                .offset = aligned_offset,
+                .size = size,
+            },
+            .node = node,
+        };
     }
 
-    Instance::Instance(Instance &&other) noexcept
+    void BufferAllocator::free(const BufferAllocation &allocation)
     {
-        std::swap(m_handle, other.m_handle);
+        auto node = allocation.node;
+        m_allocated_bytes -= m_nodes[node].size;
+        --m_allocation_count;
+
+        // Free neighbours are never left unmerged, so at most one on each side needs to be absorbed.
+        const auto previous = m_nodes[node].previous_physical;
+        if (previous != null_node && m_nodes[previous].free)
+        {
+            remove_free_node(previous);
+            merge_with_next(previous);
+            node = previous;
+        }
+
+        const auto next = m_nodes[node].next_physical;
+        if (next != null_node && m_nodes[next].free)
+        {
+            remove_free_node(next);
+            merge_with_next(node);
+        }
+
+        insert_free_node(node);
     }
 
-    Instance & Instance::operator=(const Instance &other)
+    BufferAllocatorStatistics BufferAllocator::get_statistics() const
     {
-        if (this != &other)
+        BufferAllocatorStatistics statistics
         {
-            if (m_handle != nullptr)
-            {
-                wgpuInstanceRelease(m_handle);
-            }
+            .allocated_bytes = m_allocated_bytes,
+            .allocation_count = m_allocation_count,
+            .page_count = m_pages.size(),
+        };
+
+        for (const auto &page : m_pages)
+        {
+            statistics.capacity += page.get_size();
+        }
+        statistics.free_bytes = statistics.capacity - m_allocated_bytes;
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+        for (const auto &free_lists : m_free_lists)
+        {
+            for (auto node = free_lists.begin(); node != free_lists.end(); ++node)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuInstanceReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuInstanceAddRef(m_handle);
-#endif
+                for (auto free_node = *node; free_node != null_node; free_node = m_nodes[free_node].next_free)
+                {
+                    statistics.largest_free_range = std::max(statistics.largest_free_range, m_nodes[free_node].size);
+                    ++statistics.free_range_count;
+                }
             }
         }
-        return *this;
-    }
 
-    Instance & Instance::operator=(Instance &&other) noexcept
-    {
-        if (this != &other)
+        if (statistics.free_bytes > 0)
         {
-            std::swap(m_handle, other.m_handle);
+            statistics.fragmentation = 1.0f - static_cast<float>(statistics.largest_free_range) /
+                static_cast<float>(statistics.free_bytes);
         }
-        return *this;
+
+        return statistics;
     }
 
-    WGPUInstance Instance::c_ptr() const
+    BufferAllocator::ListIndex BufferAllocator::get_list_index(const uint64_t size)
     {
-        return m_handle;
+        // Small sizes get one list each. Above that, the highest set bit picks the first level and the next
+        // second_level_log2 bits pick the second.
+        if (size < second_level_count)
+        {
+            return {0, static_cast<uint32_t>(size)};
+        }
+
+        const auto highest_bit = static_cast<uint32_t>(std::bit_width(size) - 1);
+        return
+        {
+            highest_bit - second_level_log2 + 1,
+            static_cast<uint32_t>(size >> (highest_bit - second_level_log2)) ^ second_level_count,
+        };
     }
 
-    std::expected<Adapter, std::string> Instance::create_adapter(const RequestAdapterOptions &options) const
+    uint32_t BufferAllocator::find_free_node(const uint64_t size) const
     {
-        std::expected<Adapter, std::string> result = std::unexpected("Request did not end.");
-        bool request_ended = false;
+        // Rounding up to the next list boundary means every range in the chosen list is large enough.
+        auto search_size = size;
+        if (search_size >= second_level_count)
+        {
+            search_size += (uint64_t{1} << (std::bit_width(search_size) - 1 - second_level_log2)) - 1;
+        }
 
-        auto on_adapter_request_ended = [&result, &request_ended](const RequestAdapterStatus status,
-            const Adapter& adapter, const std::string &message)
+        auto [first_level, second_level] = get_list_index(search_size);
+        auto second_level_bitmap = m_second_level_bitmaps[first_level] & (~0u << second_level);
+        if (second_level_bitmap == 0)
         {
-            if (status == RequestAdapterStatus::Success)
-            {
-                result = adapter;
-            }
-            else
+            const auto first_level_bitmap = first_level + 1 < first_level_count
+                ? m_first_level_bitmap & (~uint64_t{0} << (first_level + 1)) : 0;
+            if (first_level_bitmap == 0)
             {
-                result = std::unexpected(message);
+                return null_node;
             }
-            request_ended = true;
-        };
 
-        auto handle = request_adapter(options, on_adapter_request_ended);
-
-        // TODO: emscripten_sleep
+            first_level = static_cast<uint32_t>(std::countr_zero(first_level_bitmap));
+            second_level_bitmap = m_second_level_bitmaps[first_level];
+        }
 
-        return result;
+        second_level = static_cast<uint32_t>(std::countr_zero(second_level_bitmap));
+        return m_free_lists[first_level][second_level];
     }
 
-    void Instance::process_events() const
+    void BufferAllocator::insert_free_node(const uint32_t node)
     {
-        // wgpuInstanceProcessEvents exists on WGPU, but panics if called.
-#ifdef WEBGPU_BACKEND_DAWN
-        wgpuInstanceProcessEvents(m_handle);
-#endif
+        const auto [first_level, second_level] = get_list_index(m_nodes[node].size);
+        auto &head = m_free_lists[first_level][second_level];
+
+        m_nodes[node].free = true;
+        m_nodes[node].previous_free = null_node;
+        m_nodes[node].next_free = head;
+        if (head != null_node)
+        {
+            m_nodes[head].previous_free = node;
+        }
+        head = node;
+
+        m_first_level_bitmap |= uint64_t{1} << first_level;
+        m_second_level_bitmaps[first_level] |= 1u << second_level;
     }
 
-    std::unique_ptr<RequestAdapterCallback> Instance::request_adapter(const RequestAdapterOptions &options,
-        RequestAdapterCallback&& callback) const
+    void BufferAllocator::remove_free_node(const uint32_t node)
     {
-        auto handle = std::make_unique<RequestAdapterCallback>(callback);
-        static auto on_request_ended = [](WGPURequestAdapterStatus status, WGPUAdapter adapter,
-            const char *message, void *user_data) -> void
+        const auto [first_level, second_level] = get_list_index(m_nodes[node].size);
+        const auto previous = m_nodes[node].previous_free;
+        const auto next = m_nodes[node].next_free;
+
+        if (previous != null_node)
         {
-            const RequestAdapterCallback& callback = *static_cast<RequestAdapterCallback*>(user_data);
-            callback(static_cast<RequestAdapterStatus>(status), Adapter{adapter}, message ? message : "");
-        };
+            m_nodes[previous].next_free = next;
+        }
+        if (next != null_node)
+        {
+            m_nodes[next].previous_free = previous;
+        }
 
-        const WGPURequestAdapterOptions wgpu_options
+        auto &head = m_free_lists[first_level][second_level];
+        if (head == node)
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(options.next_in_chain),
-            .compatibleSurface = options.compatible_surface ? options.compatible_surface->c_ptr() : nullptr,
-            .powerPreference = static_cast<WGPUPowerPreference>(options.power_preference),
-            .backendType = static_cast<WGPUBackendType>(options.backend_type),
-            .forceFallbackAdapter = options.force_fallback_adapter,
-#ifdef WEBGPU_BACKEND_DAWN
-            .compatibilityMode = options.compatibility_mode,
-#endif
-        };
+            head = next;
+            if (head == null_node)
+            {
+                m_second_level_bitmaps[first_level] &= ~(1u << second_level);
+                if (m_second_level_bitmaps[first_level] == 0)
+                {
+                    m_first_level_bitmap &= ~(uint64_t{1} << first_level);
+                }
+            }
+        }
 
-        wgpuInstanceRequestAdapter(m_handle, &wgpu_options, on_request_ended, handle.get());
-        return handle;
+        m_nodes[node].free = false;
     }
 
-    PipelineLayout::PipelineLayout(const WGPUPipelineLayout &handle) : m_handle(handle)
+    void BufferAllocator::merge_with_next(const uint32_t node)
     {
-
+        const auto next = m_nodes[node].next_physical;
+        m_nodes[node].size += m_nodes[next].size;
+        m_nodes[node].next_physical = m_nodes[next].next_physical;
+        if (m_nodes[node].next_physical != null_node)
+        {
+            m_nodes[m_nodes[node].next_physical].previous_physical = node;
+        }
+        destroy_node(next);
     }
 
-    PipelineLayout::~PipelineLayout()
+    uint32_t BufferAllocator::split_node(const uint32_t node, const uint64_t size)
     {
-        if (m_handle != nullptr)
+        const auto remainder = create_node(Node
         {
-            wgpuPipelineLayoutRelease(m_handle);
+            .offset = m_nodes[node].offset + size,
+            .size = m_nodes[node].size - size,
+            .page = m_nodes[node].page,
+            .previous_physical = node,
+            .next_physical = m_nodes[node].next_physical,
+            .previous_free = null_node,
+            .next_free = null_node,
+            .free = false,
+        });
+
+        if (m_nodes[remainder].next_physical != null_node)
+        {
+            m_nodes[m_nodes[remainder].next_physical].previous_physical = remainder;
         }
+        m_nodes[node].next_physical = remainder;
+        m_nodes[node].size = size;
+
+        return remainder;
     }
 
-    PipelineLayout::PipelineLayout(const PipelineLayout &other) : m_handle(other.m_handle)
+    uint32_t BufferAllocator::create_node(const Node &node)
     {
-        if (m_handle != nullptr)
+        if (m_unused_nodes == null_node)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuPipelineLayoutReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuPipelineLayoutAddRef(m_handle);
-#endif
+            m_nodes.push_back(node);
+            return static_cast<uint32_t>(m_nodes.size() - 1);
         }
+
+        const auto index = m_unused_nodes;
+        m_unused_nodes = m_nodes[index].next_free;
+        m_nodes[index] = node;
+        return index;
     }
 
-    PipelineLayout::PipelineLayout(PipelineLayout &&other) noexcept
+    void BufferAllocator::destroy_node(const uint32_t node)
     {
-        std::swap(m_handle, other.m_handle);
+        m_nodes[node].next_free = m_unused_nodes;
+        m_unused_nodes = node;
     }
 
-    PipelineLayout& PipelineLayout::operator=(const PipelineLayout &other)
+    uint32_t BufferAllocator::add_page(const uint64_t size)
     {
-        if (this != &other)
+        const auto page_size = (size + 3) & ~uint64_t{3};
+        m_pages.push_back(m_device.create_buffer(BufferDescriptor
         {
-            if (m_handle != nullptr)
-            {
-                wgpuPipelineLayoutRelease(m_handle);
-            }
+            .label = "Buffer allocator page",
+            .usage = m_usage,
+            .size = page_size,
+        }));
 
-            if (m_handle != nullptr)
-            {
-#ifdef WEBGPU_BACKEND_WGPU
-                wgpuPipelineLayoutReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuPipelineLayoutAddRef(m_handle);
-#endif
-            }
-        }
-        return *this;
-    }
-
-    PipelineLayout& PipelineLayout::operator=(PipelineLayout &&other) noexcept
-    {
-        if (this != &other)
+        return create_node(Node
         {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+            .offset = 0,
+            .size = page_size,
+            .page = static_cast<uint32_t>(m_pages.size() - 1),
+            .previous_physical = null_node,
+            .next_physical = null_node,
+            .previous_free = null_node,
+            .next_free = null_node,
+            .free = false,
+        });
     }
 
-    WGPUPipelineLayout PipelineLayout::c_ptr() const
+    AsyncRenderPipeline::AsyncRenderPipeline() : m_state(std::make_shared<State>())
     {
-        return m_handle;
     }
 
-    Queue::Queue(const WGPUQueue &handle) : m_handle(handle)
+    bool AsyncRenderPipeline::is_ready() const
     {
-
+        return m_state->ready.load(std::memory_order_acquire);
     }
 
-    Queue::~Queue()
+    std::expected<RenderPipeline, std::string> AsyncRenderPipeline::get() const
     {
-        if (m_handle != nullptr)
+        if (!is_ready())
         {
-            wgpuQueueRelease(m_handle);
+            return std::unexpected("Pipeline is still compiling.");
         }
+        return m_state->result;
     }
 
-    Queue::Queue(const Queue &other) : m_handle(other.m_handle)
+    const RenderPipeline & AsyncRenderPipeline::get_or(const RenderPipeline &placeholder) const
     {
-        if (m_handle != nullptr)
+        // The result is written once, before ready is set, so it can be read without a lock afterwards.
+        if (!is_ready() || !m_state->result)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuQueueReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuQueueAddRef(m_handle);
-#endif
+            return placeholder;
         }
+        return *m_state->result;
     }
 
-    Queue::Queue(Queue &&other) noexcept
+    FenceTracker::FenceTracker(const Queue &queue) : m_queue(queue)
     {
-        std::swap(m_handle, other.m_handle);
     }
 
-    Queue& Queue::operator=(const Queue &other)
+    uint64_t FenceTracker::submit(const std::span<const CommandBuffer> commands)
     {
-        if (this != &other)
-        {
-            if (m_handle != nullptr)
-            {
-                wgpuQueueRelease(m_handle);
-            }
+        m_queue.submit(commands);
+        wgpuQueueOnSubmittedWorkDone(m_queue.c_ptr(), on_work_done, this);
 
-            if (m_handle != nullptr)
-            {
-#ifdef WEBGPU_BACKEND_WGPU
-                wgpuQueueReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuQueueAddRef(m_handle);
-#endif
-            }
-        }
-        return *this;
+        return ++m_last_submitted_serial;
     }
 
-    Queue& Queue::operator=(Queue &&other) noexcept
+    uint64_t FenceTracker::submit(const std::initializer_list<CommandBuffer> commands)
     {
-        if (this != &other)
-        {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+        return submit(std::span{commands.begin(), commands.size()});
     }
 
-    WGPUQueue Queue::c_ptr() const
+    bool FenceTracker::is_complete(const uint64_t serial) const
     {
-        return m_handle;
+        return serial <= get_completed_serial();
     }
 
-    void Queue::submit(const std::vector<CommandBuffer> &commands) const
+    uint64_t FenceTracker::get_completed_serial() const
     {
-        std::vector<WGPUCommandBuffer> wgpu_commands;
-        wgpu_commands.reserve(commands.size());
-        for (const auto &command : commands)
-        {
-            wgpu_commands.push_back(command.c_ptr());
-        }
-
-        wgpuQueueSubmit(m_handle, wgpu_commands.size(), wgpu_commands.data());
+        return m_completed_serial.load(std::memory_order_acquire);
     }
 
-    RenderPassEncoder::RenderPassEncoder(const WGPURenderPassEncoder &handle) : m_handle(handle)
+    uint64_t FenceTracker::get_last_submitted_serial() const
     {
-
+        return m_last_submitted_serial;
     }
 
-    RenderPassEncoder::~RenderPassEncoder()
+    const Queue & FenceTracker::get_queue() const
     {
-        if (m_handle != nullptr)
-        {
-            wgpuRenderPassEncoderRelease(m_handle);
-        }
+        return m_queue;
     }
 
-    RenderPassEncoder::RenderPassEncoder(const RenderPassEncoder &other) : m_handle(other.m_handle)
+    QueueWorkDoneStatus FenceTracker::get_status() const
     {
-        if (m_handle != nullptr)
-        {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuRenderPassEncoderReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuRenderPassEncoderAddRef(m_handle);
-#endif
-        }
+        return m_status.load(std::memory_order_acquire);
     }
 
-    RenderPassEncoder::RenderPassEncoder(RenderPassEncoder &&other) noexcept
+    FenceAwaitable FenceTracker::wait(Executor &executor, const uint64_t serial)
     {
-        std::swap(m_handle, other.m_handle);
+        return FenceAwaitable{executor, *this, serial};
     }
 
-    RenderPassEncoder& RenderPassEncoder::operator=(const RenderPassEncoder &other)
+    void FenceTracker::on_work_done(const WGPUQueueWorkDoneStatus status, void *user_data)
     {
-        if (this != &other)
+        // A failed submission is still finished as far as its resources are concerned, so every status advances
+        // the serial. Otherwise a lost device would leave waiters suspended forever. The failure is kept for
+        // get_status().
+        auto &tracker = *static_cast<FenceTracker *>(user_data);
+        if (status != WGPUQueueWorkDoneStatus_Success)
         {
-            if (m_handle != nullptr)
+            auto expected = QueueWorkDoneStatus::Success;
+            tracker.m_status.compare_exchange_strong(expected, static_cast<QueueWorkDoneStatus>(status),
+                std::memory_order_acq_rel);
+        }
+
+        const auto completed_serial = tracker.m_completed_serial.fetch_add(1, std::memory_order_acq_rel) + 1;
+
+        const std::lock_guard lock{tracker.m_waiters_mutex};
+        std::erase_if(tracker.m_waiters, [completed_serial](FenceAwaitable *waiter)
+        {
+            if (waiter->m_serial > completed_serial)
             {
-                wgpuRenderPassEncoderRelease(m_handle);
+                return false;
             }
 
-            if (m_handle != nullptr)
+            waiter->complete();
+            return true;
+        });
+    }
+
+    GpuProfiler::GpuProfiler(const Device &device, const uint32_t max_scopes_per_frame, const uint32_t frame_count)
+        : m_slots(std::max(frame_count, 1u)), m_max_queries(max_scopes_per_frame * 2)
+    {
+        const uint64_t buffer_size = m_max_queries * sizeof(uint64_t);
+
+        for (auto &slot : m_slots)
+        {
+            slot.query_set = device.create_query_set(
             {
-#ifdef WEBGPU_BACKEND_WGPU
-                wgpuRenderPassEncoderReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuRenderPassEncoderAddRef(m_handle);
-#endif
-            }
+                .label = "GPU Profiler Query Set",
+                .type = QueryType::Timestamp,
+                .count = m_max_queries,
+            });
+            slot.resolve_buffer = device.create_buffer(
+            {
+                .label = "GPU Profiler Resolve Buffer",
+                .usage = BufferUsageFlags::QueryResolve | BufferUsageFlags::CopySrc,
+                .size = buffer_size,
+                .mapped_at_creation = false,
+            });
+            slot.readback_buffer = device.create_buffer(
+            {
+                .label = "GPU Profiler Readback Buffer",
+                .usage = BufferUsageFlags::CopyDst | BufferUsageFlags::MapRead,
+                .size = buffer_size,
+                .mapped_at_creation = false,
+            });
         }
-        return *this;
     }
 
-    RenderPassEncoder& RenderPassEncoder::operator=(RenderPassEncoder &&other) noexcept
+    GpuProfiler::~GpuProfiler()
+    {
+        const std::lock_guard lock{m_lifetime->mutex};
+        m_lifetime->alive = false;
+    }
+
+    void GpuProfiler::begin_frame()
     {
-        if (this != &other)
+        m_current_slot = m_frame_index++ % m_slots.size();
+
+        auto &slot = m_slots[m_current_slot];
+        const std::lock_guard lock{m_lifetime->mutex};
+
+        // A slot still Recording or Resolved never had its readback started, because resolve() or end_frame() was
+        // skipped for that frame, so it is reclaimed rather than left unusable.
+        m_recording = slot.state != SlotState::Mapping;
+        if (!m_recording)
         {
-            std::swap(m_handle, other.m_handle);
+            ++m_dropped_frame_count;
+            return;
         }
-        return *this;
+
+        slot.state = SlotState::Recording;
+        slot.query_count = 0;
+        slot.scope_names.clear();
     }
 
-    WGPURenderPassEncoder RenderPassEncoder::c_ptr() const
+    std::optional<ComputePassTimestampWrites> GpuProfiler::begin_compute_pass_scope(std::string name)
     {
-        return m_handle;
+        const auto first_query = allocate_scope(std::move(name));
+        if (!first_query)
+        {
+            return std::nullopt;
+        }
+
+        return ComputePassTimestampWrites
+        {
+            .query_set = m_slots[m_current_slot].query_set,
+            .beginning_of_pass_write_index = *first_query,
+            .end_of_pass_write_index = *first_query + 1,
+        };
     }
 
-    void RenderPassEncoder::draw(const uint32_t vertex_count, const uint32_t instance_count,
-        const uint32_t first_vertex, const uint32_t first_instance) const
+    std::optional<RenderPassTimestampWrites> GpuProfiler::begin_render_pass_scope(std::string name)
     {
-        wgpuRenderPassEncoderDraw(m_handle, vertex_count, instance_count, first_vertex, first_instance);
+        const auto first_query = allocate_scope(std::move(name));
+        if (!first_query)
+        {
+            return std::nullopt;
+        }
+
+        return RenderPassTimestampWrites
+        {
+            .query_set = m_slots[m_current_slot].query_set,
+            .beginning_of_pass_write_index = *first_query,
+            .end_of_pass_write_index = *first_query + 1,
+        };
     }
 
-    void RenderPassEncoder::draw_indexed(const uint32_t index_count, const uint32_t instance_count,
-        const uint32_t first_index, const int32_t base_vertex, const uint32_t first_instance) const
+    void GpuProfiler::resolve(const CommandEncoder &encoder)
     {
-        wgpuRenderPassEncoderDrawIndexed(m_handle, index_count, instance_count, first_index, base_vertex,
-            first_instance);
+        if (!m_recording)
+        {
+            return;
+        }
+        m_recording = false;
+
+        auto &slot = m_slots[m_current_slot];
+        if (slot.query_count == 0)
+        {
+            const std::lock_guard lock{m_lifetime->mutex};
+            slot.state = SlotState::Idle;
+            return;
+        }
+
+        const uint64_t size = slot.query_count * sizeof(uint64_t);
+        encoder.resolve_query_set(slot.query_set, 0, slot.query_count, slot.resolve_buffer, 0);
+        encoder.copy_buffer_to_buffer(slot.resolve_buffer, 0, slot.readback_buffer, 0, size);
+
+        const std::lock_guard lock{m_lifetime->mutex};
+        slot.state = SlotState::Resolved;
     }
 
-    void RenderPassEncoder::end() const
+    void GpuProfiler::end_frame()
     {
-        wgpuRenderPassEncoderEnd(m_handle);
+        auto &slot = m_slots[m_current_slot];
+        {
+            const std::lock_guard lock{m_lifetime->mutex};
+            if (slot.state != SlotState::Resolved)
+            {
+                return;
+            }
+            slot.state = SlotState::Mapping;
+        }
+
+        read_back(slot);
     }
 
-    void RenderPassEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
-        const std::vector<uint32_t> &dynamic_offsets) const
+    std::vector<GpuProfiler::ScopeTiming> GpuProfiler::get_results() const
     {
-        wgpuRenderPassEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(), dynamic_offsets.data());
+        const std::lock_guard lock{m_lifetime->mutex};
+        return m_results;
     }
 
-    void RenderPassEncoder::set_index_buffer(const Buffer &buffer, const IndexFormat format, const uint64_t offset,
-        const uint64_t size) const
+    uint64_t GpuProfiler::get_dropped_frame_count() const
     {
-        wgpuRenderPassEncoderSetIndexBuffer(m_handle, buffer.c_ptr(), static_cast<WGPUIndexFormat>(format), offset,
-            size);
+        return m_dropped_frame_count;
     }
 
-    void RenderPassEncoder::set_pipeline(const RenderPipeline &pipeline) const
+    std::optional<uint32_t> GpuProfiler::allocate_scope(std::string &&name)
     {
-        wgpuRenderPassEncoderSetPipeline(m_handle, pipeline.c_ptr());
+        auto &slot = m_slots[m_current_slot];
+        if (!m_recording || slot.query_count + 2 > m_max_queries)
+        {
+            return std::nullopt;
+        }
+
+        const auto first_query = slot.query_count;
+        slot.query_count += 2;
+        slot.scope_names.push_back(std::move(name));
+
+        return first_query;
     }
 
-    void RenderPassEncoder::set_vertex_buffer(const uint32_t slot, const Buffer &buffer, const uint64_t offset,
-        const uint64_t size) const
+    void GpuProfiler::read_back(Slot &slot)
     {
-        wgpuRenderPassEncoderSetVertexBuffer(m_handle, slot, buffer.c_ptr(), offset, size);
-    }
+        const size_t size = slot.query_count * sizeof(uint64_t);
+        slot.readback_buffer.map_async(MapModeFlags::Read, 0, size,
+            [this, &slot, lifetime = m_lifetime](const BufferMapAsyncStatus status)
+            {
+                const std::lock_guard lock{lifetime->mutex};
+                if (!lifetime->alive)
+                {
+                    return;
+                }
+
+                if (status != BufferMapAsyncStatus::Success)
+                {
+                    slot.state = SlotState::Idle;
+                    return;
+                }
+
+                const auto *timestamps = slot.readback_buffer.get_const_mapped_range<uint64_t>(0, slot.query_count);
+
+                m_results.resize(slot.scope_names.size());
+                for (size_t i = 0; i < slot.scope_names.size(); ++i)
+                {
+                    const auto begin = timestamps[i * 2];
+                    const auto end = timestamps[i * 2 + 1];
 
-    RenderPipeline::RenderPipeline(const WGPURenderPipeline &handle) : m_handle(handle)
-    {
+                    // Timestamps are not guaranteed to be monotonic across a pass, so clamp rather than wrap.
+                    m_results[i].name = slot.scope_names[i];
+                    m_results[i].duration_ns = end > begin ? end - begin : 0;
+                }
 
+                slot.readback_buffer.unmap();
+                slot.state = SlotState::Idle;
+            });
     }
 
-    RenderPipeline::~RenderPipeline()
+    Executor::Executor() : m_processes_events(false)
     {
-        if (m_handle != nullptr)
-        {
-            wgpuRenderPipelineRelease(m_handle);
-        }
     }
 
-    RenderPipeline::RenderPipeline(const RenderPipeline &other) : m_handle(other.m_handle)
+    Executor::Executor(const Instance &instance, const std::chrono::microseconds max_idle_wait) :
+        m_instance(instance), m_processes_events(true), m_max_idle_wait(max_idle_wait)
     {
-        if (m_handle != nullptr)
-        {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuRenderPipelineReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuRenderPipelineAddRef(m_handle);
-#endif
-        }
     }
 
-    RenderPipeline::RenderPipeline(RenderPipeline &&other) noexcept
+    CallbackPool & CallbackPool::get()
     {
-        std::swap(m_handle, other.m_handle);
+        static CallbackPool pool;
+        return pool;
     }
 
-    RenderPipeline& RenderPipeline::operator=(const RenderPipeline &other)
+    void * CallbackPool::allocate()
     {
-        if (this != &other)
-        {
-            if (m_handle != nullptr)
-            {
-                wgpuRenderPipelineRelease(m_handle);
-            }
+        const std::lock_guard lock{m_mutex};
 
-            if (m_handle != nullptr)
+        if (!m_free_list)
+        {
+            auto slab = std::make_unique<Slot[]>(slots_per_slab);
+            for (size_t i = 0; i < slots_per_slab; ++i)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-                wgpuRenderPipelineReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuRenderPipelineAddRef(m_handle);
-#endif
+                slab[i].next = i + 1 < slots_per_slab ? &slab[i + 1] : nullptr;
             }
+            m_free_list = slab.get();
+            m_slabs.push_back(std::move(slab));
         }
-        return *this;
-    }
 
-    RenderPipeline& RenderPipeline::operator=(RenderPipeline &&other) noexcept
-    {
-        if (this != &other)
-        {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+        auto *slot = m_free_list;
+        m_free_list = slot->next;
+        ++m_in_flight_count;
+
+        return slot->storage;
     }
 
-    WGPURenderPipeline RenderPipeline::c_ptr() const
+    void CallbackPool::deallocate(void *slot)
     {
-        return m_handle;
+        const std::lock_guard lock{m_mutex};
+
+        auto *free_slot = ::new (slot) Slot;
+        free_slot->next = m_free_list;
+        m_free_list = free_slot;
+        --m_in_flight_count;
     }
 
-    Sampler::Sampler(const WGPUSampler &handle) : m_handle(handle)
+    size_t CallbackPool::get_capacity() const
     {
-
+        const std::lock_guard lock{m_mutex};
+        return m_slabs.size() * slots_per_slab;
     }
 
-    Sampler::~Sampler()
+    size_t CallbackPool::get_in_flight_count() const
     {
-        if (m_handle != nullptr)
-        {
-            wgpuSamplerRelease(m_handle);
-        }
+        const std::lock_guard lock{m_mutex};
+        return m_in_flight_count;
     }
 
-    Sampler::Sampler(const Sampler &other) : m_handle(other.m_handle)
+    ErrorSink::ErrorSink(const size_t capacity)
     {
-        if (m_handle != nullptr)
+        const auto cell_count = std::bit_ceil(std::max<size_t>(capacity, 2));
+        m_cells = std::make_unique<Cell[]>(cell_count);
+        m_mask = cell_count - 1;
+
+        for (size_t i = 0; i < cell_count; ++i)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuSamplerReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuSamplerAddRef(m_handle);
-#endif
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
         }
     }
 
-    Sampler::Sampler(Sampler &&other) noexcept
+    bool ErrorSink::push(const ErrorType type, const std::string_view message)
     {
-        std::swap(m_handle, other.m_handle);
-    }
+        auto position = m_enqueue_position.load(std::memory_order_relaxed);
 
-    Sampler& Sampler::operator=(const Sampler &other)
-    {
-        if (this != &other)
+        while (true)
         {
-            if (m_handle != nullptr)
+            auto &cell = m_cells[position & m_mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+            if (difference == 0)
+            {
+                if (m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    cell.type = type;
+                    cell.message_length = std::min(message.size(), max_message_length);
+                    std::copy_n(message.data(), cell.message_length, cell.message);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
             {
-                wgpuSamplerRelease(m_handle);
+                // The consumer has not freed this cell since the last lap, so the ring is full.
+                m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return false;
             }
-
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+            else
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuSamplerReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuSamplerAddRef(m_handle);
-#endif
+                position = m_enqueue_position.load(std::memory_order_relaxed);
             }
         }
-        return *this;
     }
 
-    Sampler& Sampler::operator=(Sampler &&other) noexcept
+    std::optional<DeviceError> ErrorSink::try_pop()
     {
-        if (this != &other)
+        auto position = m_dequeue_position.load(std::memory_order_relaxed);
+
+        while (true)
         {
-            std::swap(m_handle, other.m_handle);
+            auto &cell = m_cells[position & m_mask];
+            const auto sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+            if (difference == 0)
+            {
+                if (m_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    DeviceError error
+                    {
+                        .type = cell.type,
+                        .message = std::string{cell.message, cell.message_length},
+                    };
+                    cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+                    return error;
+                }
+            }
+            else if (difference < 0)
+            {
+                return std::nullopt;
+            }
+            else
+            {
+                position = m_dequeue_position.load(std::memory_order_relaxed);
+            }
         }
-        return *this;
     }
 
-    WGPUSampler Sampler::c_ptr() const
+    size_t ErrorSink::get_capacity() const
     {
-        return m_handle;
+        return m_mask + 1;
     }
 
-    ShaderModule::ShaderModule(const WGPUShaderModule &handle) : m_handle(handle)
+    uint64_t ErrorSink::get_dropped_count() const
     {
-
+        return m_dropped_count.load(std::memory_order_relaxed);
     }
 
-    ShaderModule::~ShaderModule()
+    void Executor::add_device(const Device &device)
     {
-        if (m_handle != nullptr)
-        {
-            wgpuShaderModuleRelease(m_handle);
-        }
+        m_devices.push_back(device);
     }
 
-    ShaderModule::ShaderModule(const ShaderModule &other) : m_handle(other.m_handle)
+    void Executor::schedule(const std::coroutine_handle<> handle)
     {
-        if (m_handle != nullptr)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuShaderModuleReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuShaderModuleAddRef(m_handle);
-#endif
+            const std::lock_guard lock{m_mutex};
+            m_ready.push_back(handle);
         }
+        m_ready_condition.notify_one();
     }
 
-    ShaderModule::ShaderModule(ShaderModule &&other) noexcept
+    void Executor::spawn(Task<void> &&task)
     {
-        std::swap(m_handle, other.m_handle);
+        const auto handle = task.m_handle;
+        m_spawned.push_back(std::move(task));
+        handle.resume();
     }
 
-    ShaderModule& ShaderModule::operator=(const ShaderModule &other)
+    bool Executor::poll()
     {
-        if (this != &other)
+        if (m_processes_events)
         {
-            if (m_handle != nullptr)
+            m_instance.process_events();
+            for (const auto &device : m_devices)
             {
-                wgpuShaderModuleRelease(m_handle);
-            }
-
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
-            {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuShaderModuleReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuShaderModuleAddRef(m_handle);
-#endif
+                device.tick();
             }
         }
-        return *this;
-    }
 
-    ShaderModule& ShaderModule::operator=(ShaderModule &&other) noexcept
-    {
-        if (this != &other)
         {
-            std::swap(m_handle, other.m_handle);
+            const std::lock_guard lock{m_mutex};
+            std::swap(m_ready, m_resuming);
         }
-        return *this;
-    }
 
-    WGPUShaderModule ShaderModule::c_ptr() const
-    {
-        return m_handle;
-    }
+        const auto resumed = !m_resuming.empty();
+        if (resumed)
+        {
+            m_idle_wait = std::chrono::microseconds{0};
+        }
+        for (const auto handle : m_resuming)
+        {
+            handle.resume();
+        }
+        m_resuming.clear();
 
-    Surface::Surface(const WGPUSurface &handle) : m_handle(handle)
-    {
+        std::erase_if(m_spawned, [](const Task<void> &task) { return task.is_done(); });
 
+        return resumed;
     }
 
-    Surface::~Surface()
+    void Executor::run_until_idle()
     {
-        if (m_handle != nullptr)
+        while (!m_spawned.empty())
         {
-            wgpuSurfaceRelease(m_handle);
+            if (!poll())
+            {
+                wait_for_work();
+            }
         }
     }
 
-    Surface::Surface(const Surface &other) : m_handle(other.m_handle)
+    size_t Executor::get_pending_operation_count() const
     {
-        if (m_handle != nullptr)
-        {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuSurfaceReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuSurfaceAddRef(m_handle);
-#endif
-        }
+        return m_pending_operations.load(std::memory_order_relaxed);
     }
 
-    Surface::Surface(Surface &&other) noexcept
+    void Executor::wait_for_work()
     {
-        std::swap(m_handle, other.m_handle);
-    }
+        const auto is_ready = [this] { return !m_ready.empty(); };
 
-    Surface& Surface::operator=(const Surface &other)
-    {
-        if (this != &other)
+        if (!m_processes_events)
         {
-            if (m_handle != nullptr)
-            {
-                wgpuSurfaceRelease(m_handle);
-            }
+            std::unique_lock lock{m_mutex};
+            m_ready_condition.wait(lock, is_ready);
+            return;
+        }
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
-            {
 #ifdef WEBGPU_BACKEND_WGPU
-            wgpuSurfaceReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuSurfaceAddRef(m_handle);
-#endif
-            }
+        // Callbacks fire while the device is polled, so blocking until its queue drains wakes as soon as the
+        // submitted work they wait on has finished.
+        for (const auto &device : m_devices)
+        {
+            wgpuDevicePoll(device.c_ptr(), true, nullptr);
         }
-        return *this;
+#endif
+
+        // Callbacks only fire while this thread processes events, so there is nothing to be woken by here other
+        // than schedule() from another thread. Back off instead of spinning while idle.
+        constexpr std::chrono::microseconds min_idle_wait{50};
+        m_idle_wait = std::clamp(m_idle_wait * 2, min_idle_wait, std::max(min_idle_wait, m_max_idle_wait));
+
+        std::unique_lock lock{m_mutex};
+        m_ready_condition.wait_for(lock, m_idle_wait, is_ready);
     }
 
-    Surface& Surface::operator=(Surface &&other) noexcept
+    void ExecutorAwaitable::begin(const std::coroutine_handle<> handle)
     {
-        if (this != &other)
-        {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+        m_handle = handle;
+        m_executor.m_pending_operations.fetch_add(1, std::memory_order_relaxed);
     }
 
-    WGPUSurface Surface::c_ptr() const
+    void ExecutorAwaitable::complete()
     {
-        return m_handle;
+        m_executor.m_pending_operations.fetch_sub(1, std::memory_order_relaxed);
+        m_executor.schedule(m_handle);
     }
 
-    void Surface::configure(const SurfaceConfiguration &configuration) const
+    struct DeviceRequestAwaitable::OwnedDescriptor
     {
-        const WGPUSurfaceConfiguration wgpu_configuration
+        explicit OwnedDescriptor(const DeviceDescriptor &source) : descriptor(source)
         {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(configuration.next_in_chain),
-            .device = configuration.device.c_ptr(),
-            .format = static_cast<WGPUTextureFormat>(configuration.format),
-            .usage = static_cast<WGPUTextureUsageFlags>(configuration.usage),
-            .viewFormatCount = configuration.view_formats.size(),
-            .viewFormats = reinterpret_cast<const WGPUTextureFormat *>(configuration.view_formats.data()),
-            .alphaMode = static_cast<WGPUCompositeAlphaMode>(configuration.alpha_mode),
-            .width = configuration.width,
-            .height = configuration.height,
-            .presentMode = static_cast<WGPUPresentMode>(configuration.present_mode),
-        };
+            own_label(descriptor.label, label);
+            own_label(descriptor.default_queue.label, queue_label);
+        }
 
-        wgpuSurfaceConfigure(m_handle, &wgpu_configuration);
-    }
+        std::string label;
+        std::string queue_label;
+        DeviceDescriptor descriptor;
+    };
 
-    SurfaceCapabilities Surface::get_capabilities(const Adapter &adapter) const
+    struct RenderPipelineCreateAwaitable::OwnedDescriptor
     {
-        WGPUSurfaceCapabilities wgpu_capabilities{};
-        // TODO: On Dawn, this returns a WGPUStatus. This should be checked and handled.
-        // However, it only returns WGPUStatus_Error for some reason during testing.
-        wgpuSurfaceGetCapabilities(m_handle, adapter.c_ptr(), &wgpu_capabilities);
-
-        return SurfaceCapabilities
+        explicit OwnedDescriptor(const RenderPipelineDescriptor &source)
+            : descriptor(source), layout(retain(source.layout)), vertex_module(retain(source.vertex.module)),
+              fragment_module(source.fragment ? retain(source.fragment->module) : ShaderModule{})
         {
-            .next_in_chain = reinterpret_cast<ChainedStructOut *>(wgpu_capabilities.nextInChain),
-#ifdef WEBGPU_BACKEND_DAWN
-            .usages = static_cast<TextureUsageFlags>(wgpu_capabilities.usages),
-#endif
-            .formats = std::vector<TextureFormat>
-            {
-                reinterpret_cast<const TextureFormat *>(wgpu_capabilities.formats),
-                reinterpret_cast<const TextureFormat *>(wgpu_capabilities.formats) + wgpu_capabilities.formatCount
-            },
-            .present_modes = std::vector<PresentMode>
-            {
-                reinterpret_cast<const PresentMode *>(wgpu_capabilities.presentModes),
-                reinterpret_cast<const PresentMode *>(wgpu_capabilities.presentModes) + wgpu_capabilities.presentModeCount
-            },
-            .alpha_modes = std::vector<CompositeAlphaMode>
-            {
-                reinterpret_cast<const CompositeAlphaMode *>(wgpu_capabilities.alphaModes),
-                reinterpret_cast<const CompositeAlphaMode *>(wgpu_capabilities.alphaModes) + wgpu_capabilities.alphaModeCount
-            },
-        };
-    }
-
-    SurfaceTexture Surface::get_current_texture() const
-    {
-        WGPUSurfaceTexture wgpu_surface_texture{};
-        wgpuSurfaceGetCurrentTexture(m_handle, &wgpu_surface_texture);
+            own_label(descriptor.label, label);
+        }
 
-        return SurfaceTexture
-        {
-            .texture = Texture{wgpu_surface_texture.texture},
-            .suboptimal = static_cast<bool>(wgpu_surface_texture.suboptimal),
-            .status = static_cast<SurfaceGetCurrentTextureStatus>(wgpu_surface_texture.status),
-        };
-    }
+        std::string label;
+        RenderPipelineDescriptor descriptor;
+        PipelineLayout layout;
+        ShaderModule vertex_module;
+        ShaderModule fragment_module;
+    };
 
-    void Surface::present() const
+    AdapterRequestAwaitable::AdapterRequestAwaitable(Executor &executor, const Instance &instance,
+        const RequestAdapterOptions &options)
+        : ExecutorAwaitable(executor), m_instance(instance), m_options(std::make_unique<RequestAdapterOptions>(options))
     {
-        wgpuSurfacePresent(m_handle);
     }
 
-    void Surface::unconfigure() const
-    {
-        wgpuSurfaceUnconfigure(m_handle);
-    }
+    AdapterRequestAwaitable::~AdapterRequestAwaitable() = default;
 
-    Texture::Texture(const WGPUTexture &handle) : m_handle(handle)
+    void AdapterRequestAwaitable::await_suspend(const std::coroutine_handle<> handle)
     {
+        begin(handle);
 
+        // The callback may resume the coroutine as soon as the request is issued, so nothing may touch this
+        // awaitable afterwards.
+        const auto wgpu_options = translate_request_adapter_options(*m_options);
+        wgpuInstanceRequestAdapter(m_instance.c_ptr(), &wgpu_options, on_request_ended, this);
     }
 
-    Texture::~Texture()
+    std::expected<Adapter, std::string> AdapterRequestAwaitable::await_resume()
     {
-        if (m_handle != nullptr)
-        {
-            wgpuTextureRelease(m_handle);
-        }
+        return std::move(m_result);
     }
 
-    Texture::Texture(const Texture &other) : m_handle(other.m_handle)
+    void AdapterRequestAwaitable::on_request_ended(const WGPURequestAdapterStatus status, const WGPUAdapter adapter,
+        const char *message, void *user_data)
     {
-        if (m_handle != nullptr)
+        auto &awaitable = *static_cast<AdapterRequestAwaitable *>(user_data);
+        if (static_cast<RequestAdapterStatus>(status) == RequestAdapterStatus::Success)
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuTextureReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuTextureAddRef(m_handle);
-#endif
+            awaitable.m_result = Adapter{adapter};
+        }
+        else
+        {
+            awaitable.m_result = std::unexpected(message ? message : "");
         }
+        awaitable.complete();
     }
 
-    Texture::Texture(Texture &&other) noexcept
+    BufferMapAwaitable::BufferMapAwaitable(Executor &executor, const Buffer &buffer, const MapModeFlags mode,
+        const size_t offset, const size_t size)
+        : ExecutorAwaitable(executor), m_buffer(buffer), m_mode(mode), m_offset(offset), m_size(size)
     {
-        std::swap(m_handle, other.m_handle);
     }
 
-    Texture & Texture::operator=(const Texture &other)
+    void BufferMapAwaitable::await_suspend(const std::coroutine_handle<> handle)
     {
-        if (this != &other)
-        {
-            if (m_handle != nullptr)
-            {
-                wgpuTextureRelease(m_handle);
-            }
-
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
-            {
-#ifdef WEBGPU_BACKEND_WGPU
-                wgpuTextureReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-                wgpuTextureAddRef(m_handle);
-#endif
-            }
-        }
-        return *this;
+        begin(handle);
+        wgpuBufferMapAsync(m_buffer.c_ptr(), static_cast<WGPUMapModeFlags>(m_mode), m_offset, m_size,
+            on_buffer_mapped, this);
     }
 
-    Texture & Texture::operator=(Texture &&other) noexcept
+    BufferMapAsyncStatus BufferMapAwaitable::await_resume() const
     {
-        if (this != &other)
-        {
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+        return m_status;
     }
 
-    WGPUTexture Texture::c_ptr() const
+    void BufferMapAwaitable::on_buffer_mapped(const WGPUBufferMapAsyncStatus status, void *user_data)
     {
-        return m_handle;
+        auto &awaitable = *static_cast<BufferMapAwaitable *>(user_data);
+        awaitable.m_status = static_cast<BufferMapAsyncStatus>(status);
+        awaitable.complete();
     }
 
-    TextureView Texture::create_view() const
+    DeviceRequestAwaitable::DeviceRequestAwaitable(Executor &executor, const Adapter &adapter,
+        const DeviceDescriptor &descriptor)
+        : ExecutorAwaitable(executor), m_adapter(adapter), m_descriptor(std::make_unique<OwnedDescriptor>(descriptor))
     {
-        return TextureView{m_handle, wgpuTextureCreateView(m_handle, nullptr)};
     }
 
-    TextureView Texture::create_view(const TextureViewDescriptor &descriptor) const
+    DeviceRequestAwaitable::~DeviceRequestAwaitable() = default;
+
+    void DeviceRequestAwaitable::await_suspend(const std::coroutine_handle<> handle)
     {
-        const WGPUTextureViewDescriptor wgpu_descriptor
-        {
-            .nextInChain = reinterpret_cast<const WGPUChainedStruct *>(descriptor.next_in_chain),
-            .label = descriptor.label.c_str(),
-            .format = static_cast<WGPUTextureFormat>(descriptor.format),
-            .dimension = static_cast<WGPUTextureViewDimension>(descriptor.dimension),
-            .baseMipLevel = descriptor.base_mip_level,
-            .mipLevelCount = descriptor.mip_level_count,
-            .baseArrayLayer = descriptor.base_array_layer,
-            .arrayLayerCount = descriptor.array_layer_count,
-            .aspect = static_cast<WGPUTextureAspect>(descriptor.aspect),
-        };
+        begin(handle);
 
-        return TextureView{m_handle, wgpuTextureCreateView(m_handle, &wgpu_descriptor)};
+        m_device_lost_callback = make_device_lost_callback(m_descriptor->descriptor);
+        const auto wgpu_descriptor = translate_device_descriptor(m_descriptor->descriptor, m_device_lost_callback);
+        wgpuAdapterRequestDevice(m_adapter.c_ptr(), &wgpu_descriptor, on_request_ended, this);
     }
 
-    uint32_t Texture::get_depth_or_array_layers() const
+    std::expected<Device, std::string> DeviceRequestAwaitable::await_resume()
     {
-        return wgpuTextureGetDepthOrArrayLayers(m_handle);
+        return std::move(m_result);
     }
 
-    TextureDimension Texture::get_dimension() const
+    void DeviceRequestAwaitable::on_request_ended(const WGPURequestDeviceStatus status, const WGPUDevice device,
+        const char *message, void *user_data)
     {
-        return static_cast<TextureDimension>(wgpuTextureGetDimension(m_handle));
+        auto &awaitable = *static_cast<DeviceRequestAwaitable *>(user_data);
+        if (static_cast<RequestDeviceStatus>(status) == RequestDeviceStatus::Success)
+        {
+            awaitable.m_result = Device{device};
+#ifdef WEBGPU_BACKEND_WGPU
+            set_uncaptured_error_callback(*awaitable.m_result, awaitable.m_descriptor->descriptor.error_sink);
+#endif
+        }
+        else
+        {
+            release_device_lost_callback(awaitable.m_device_lost_callback);
+            awaitable.m_result = std::unexpected(message ? message : "");
+        }
+        awaitable.complete();
     }
 
-    TextureFormat Texture::get_format() const
+    ErrorScopeAwaitable::ErrorScopeAwaitable(Executor &executor, const Device &device)
+        : ExecutorAwaitable(executor), m_device(device)
     {
-        return static_cast<TextureFormat>(wgpuTextureGetFormat(m_handle));
     }
 
-    uint32_t Texture::get_height() const
+    void ErrorScopeAwaitable::await_suspend(const std::coroutine_handle<> handle)
     {
-        return wgpuTextureGetHeight(m_handle);
+        begin(handle);
+#ifdef WEBGPU_BACKEND_WGPU
+        const std::lock_guard lock{get_error_scope_mutex()};
+#endif
+        wgpuDevicePopErrorScope(m_device.c_ptr(), on_error_scope_popped, this);
     }
 
-    uint32_t Texture::get_mip_level_count() const
+    DeviceError ErrorScopeAwaitable::await_resume()
     {
-        return wgpuTextureGetMipLevelCount(m_handle);
+        return DeviceError{.type = m_type, .message = std::move(m_message)};
     }
 
-    uint32_t Texture::get_sample_count() const
+    void ErrorScopeAwaitable::on_error_scope_popped(const WGPUErrorType type, const char *message, void *user_data)
     {
-        return wgpuTextureGetSampleCount(m_handle);
+        auto &awaitable = *static_cast<ErrorScopeAwaitable *>(user_data);
+        awaitable.m_type = static_cast<ErrorType>(type);
+        awaitable.m_message = message ? message : "";
+        awaitable.complete();
     }
 
-    TextureUsageFlags Texture::get_usage() const
+    FenceAwaitable::FenceAwaitable(Executor &executor, FenceTracker &tracker, const uint64_t serial)
+        : ExecutorAwaitable(executor), m_tracker(tracker), m_serial(serial),
+          m_submitted(serial <= tracker.get_last_submitted_serial())
     {
-        return static_cast<TextureUsageFlags>(wgpuTextureGetUsage(m_handle));
     }
 
-    uint32_t Texture::get_width() const
+    bool FenceAwaitable::await_ready() const
     {
-        return wgpuTextureGetWidth(m_handle);
+        return !m_submitted || m_tracker.is_complete(m_serial);
     }
 
-    TextureView::TextureView(const WGPUTexture &texture, const WGPUTextureView &handle)
-        : m_texture(texture), m_handle(handle)
+    bool FenceAwaitable::await_suspend(const std::coroutine_handle<> handle)
     {
-        if (m_texture != nullptr)
+        const std::lock_guard lock{m_tracker.m_waiters_mutex};
+        if (!m_submitted || m_tracker.is_complete(m_serial))
         {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuTextureReference(m_texture);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuTextureAddRef(m_texture);
-#endif
+            return false;
         }
+
+        begin(handle);
+        m_tracker.m_waiters.push_back(this);
+        return true;
     }
 
-    TextureView::~TextureView()
+    QueueWorkDoneAwaitable::QueueWorkDoneAwaitable(Executor &executor, const Queue &queue)
+        : ExecutorAwaitable(executor), m_queue(queue)
     {
-        if (m_texture != nullptr)
-        {
-            wgpuTextureRelease(m_texture);
-        }
-
-        if (m_handle != nullptr)
-        {
-            wgpuTextureViewRelease(m_handle);
-        }
     }
 
-    TextureView::TextureView(const TextureView &other) : m_texture(other.m_texture), m_handle(other.m_handle)
+    void QueueWorkDoneAwaitable::await_suspend(const std::coroutine_handle<> handle)
     {
-        if (m_texture != nullptr)
-        {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuTextureReference(m_texture);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuTextureAddRef(m_texture);
-#endif
-        }
+        begin(handle);
+        wgpuQueueOnSubmittedWorkDone(m_queue.c_ptr(), on_work_done, this);
+    }
 
-        if (m_handle != nullptr)
-        {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuTextureViewReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuTextureViewAddRef(m_handle);
-#endif
-        }
+    QueueWorkDoneStatus QueueWorkDoneAwaitable::await_resume() const
+    {
+        return m_status;
     }
 
-    TextureView::TextureView(TextureView &&other) noexcept
+    void QueueWorkDoneAwaitable::on_work_done(const WGPUQueueWorkDoneStatus status, void *user_data)
     {
-        std::swap(m_texture, other.m_texture);
-        std::swap(m_handle, other.m_handle);
+        auto &awaitable = *static_cast<QueueWorkDoneAwaitable *>(user_data);
+        awaitable.m_status = static_cast<QueueWorkDoneStatus>(status);
+        awaitable.complete();
     }
 
-    TextureView& TextureView::operator=(const TextureView &other)
+    RenderPipelineCreateAwaitable::RenderPipelineCreateAwaitable(Executor &executor, const Device &device,
+        const RenderPipelineDescriptor &descriptor)
+        : ExecutorAwaitable(executor), m_device(device), m_descriptor(std::make_unique<OwnedDescriptor>(descriptor))
     {
-        if (this != &other)
-        {
-            if (m_texture != nullptr)
-            {
-                wgpuTextureRelease(m_texture);
-            }
+    }
 
-            if (m_handle != nullptr)
-            {
-                wgpuTextureViewRelease(m_handle);
-            }
+    RenderPipelineCreateAwaitable::~RenderPipelineCreateAwaitable() = default;
 
-            m_texture = other.m_texture;
-            if (m_texture != nullptr)
-            {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuTextureReference(m_texture);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuTextureAddRef(m_texture);
-#endif
-            }
+    void RenderPipelineCreateAwaitable::await_suspend(const std::coroutine_handle<> handle)
+    {
+        begin(handle);
 
-            m_handle = other.m_handle;
-            if (m_handle != nullptr)
+        m_device.create_render_pipeline_async(m_descriptor->descriptor,
+            [this](const CreatePipelineAsyncStatus status, const RenderPipeline &pipeline, const std::string &message)
             {
-#ifdef WEBGPU_BACKEND_WGPU
-            wgpuTextureViewReference(m_handle);
-#elif WEBGPU_BACKEND_DAWN
-            wgpuTextureViewAddRef(m_handle);
-#endif
-            }
-        }
-        return *this;
-    }
-
-    TextureView& TextureView::operator=(TextureView &&other) noexcept
-    {
-        if (this != &other)
-        {
-            std::swap(m_texture, other.m_texture);
-            std::swap(m_handle, other.m_handle);
-        }
-        return *this;
+                if (status == CreatePipelineAsyncStatus::Success)
+                {
+                    m_result = pipeline;
+                }
+                else
+                {
+                    m_result = std::unexpected(message);
+                }
+                complete();
+            });
     }
 
-    WGPUTextureView TextureView::c_ptr() const
+    std::expected<RenderPipeline, std::string> RenderPipelineCreateAwaitable::await_resume()
     {
-        return m_handle;
+        return std::move(m_result);
     }
 
     Instance create_instance(const InstanceDescriptor &descriptor)
@@ -1,11 +1,32 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
 #include <expected>
 #include <functional>
+#include <initializer_list>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <webgpu/webgpu.h>
+#ifdef WEBGPU_BACKEND_WGPU
+#include <webgpu/wgpu.h>
+#endif
 
 namespace wgpu
 {
@@ -16,9 +37,14 @@ namespace wgpu
     class Buffer;
     class CommandBuffer;
     class CommandEncoder;
+    class ComputePassEncoder;
+    class ComputePipeline;
     class Device;
     class PipelineLayout;
+    class QuerySet;
     class Queue;
+    class RenderBundle;
+    class RenderBundleEncoder;
     class RenderPassEncoder;
     class RenderPipeline;
     class Sampler;
@@ -27,6 +53,62 @@ namespace wgpu
     class Texture;
     class TextureView;
 
+    // RAII Handle Template Declarations
+    template<typename T>
+    struct HandleTraits;
+
+    template<typename T, typename Traits = HandleTraits<T>>
+    class Handle;
+
+    // Non-owning Handle Reference Declarations
+    template<typename T, typename C>
+    class HandleRef;
+
+    using BindGroupLayoutRef = HandleRef<BindGroupLayout, WGPUBindGroupLayout>;
+    using BufferRef = HandleRef<Buffer, WGPUBuffer>;
+    using PipelineLayoutRef = HandleRef<PipelineLayout, WGPUPipelineLayout>;
+    using QuerySetRef = HandleRef<QuerySet, WGPUQuerySet>;
+    using SamplerRef = HandleRef<Sampler, WGPUSampler>;
+    using ShaderModuleRef = HandleRef<ShaderModule, WGPUShaderModule>;
+    using TextureRef = HandleRef<Texture, WGPUTexture>;
+    using TextureViewRef = HandleRef<TextureView, WGPUTextureView>;
+
+    // Utility Forward Declarations
+    class AsyncRenderPipeline;
+    class BufferAllocator;
+    class CallbackPool;
+    class ErrorSink;
+    class EventPump;
+    class FrameArena;
+    class FenceTracker;
+    class FrameArenaScope;
+    class GpuProfiler;
+    template<typename Signature, size_t Capacity = 48>
+    class InlineFunction;
+    class Label;
+    class ParallelRecorder;
+    class RenderPipelineCache;
+    class ResourceRegistry;
+    class StagingBelt;
+    class TexturePool;
+    class ThreadPool;
+    template<typename T>
+    class Tracked;
+    class UniformRing;
+
+    // Coroutine Forward Declarations
+    class AdapterRequestAwaitable;
+    class BufferMapAwaitable;
+    class DeviceRequestAwaitable;
+    class ErrorScopeAwaitable;
+    class Executor;
+    class ExecutorAwaitable;
+    class FenceAwaitable;
+    class QueueWorkDoneAwaitable;
+    class RenderPipelineCreateAwaitable;
+    template<typename T = void>
+    class Task;
+
     // Struct Forward Declarations
     struct AdapterProperties;
     struct BindGroupDescriptor;
@@ -35,17 +117,24 @@ namespace wgpu
     struct BindGroupLayoutEntry;
     struct BlendComponent;
     struct BlendState;
+    struct BufferAllocation;
+    struct BufferAllocatorStatistics;
     struct BufferBindingLayout;
     struct BufferDescriptor;
+    struct BufferSlice;
     struct ChainedStruct;
     struct ChainedStructOut;
     struct Color;
     struct ColorTargetState;
     struct CommandBufferDescriptor;
     struct CommandEncoderDescriptor;
+    struct ComputePassDescriptor;
+    struct ComputePassTimestampWrites;
+    struct ComputePipelineDescriptor;
     struct ConstantEntry;
     struct DepthStencilState;
     struct DeviceDescriptor;
+    struct DeviceError;
     struct Extent3D;
     struct FragmentState;
     struct ImageCopyTexture;
@@ -57,13 +146,19 @@ namespace wgpu
     struct MultisampleState;
     struct Origin3D;
     struct PipelineLayoutDescriptor;
+    struct PipelineWarmUpResult;
     struct PrimitiveState;
+    struct ProgrammableStageDescriptor;
+    struct QuerySetDescriptor;
     struct QueueDescriptor;
     struct RequestAdapterOptions;
     struct RequiredLimits;
+    struct RenderBundleDescriptor;
+    struct RenderBundleEncoderDescriptor;
     struct RenderPassColorAttachment;
     struct RenderPassDepthStencilAttachment;
     struct RenderPassDescriptor;
+    struct RenderPassTimestampWrites;
     struct RenderPipelineDescriptor;
     struct SamplerBindingLayout;
     struct SamplerDescriptor;
@@ -83,6 +178,7 @@ namespace wgpu
     struct VertexAttribute;
     struct VertexBufferLayout;
     struct VertexState;
+    struct WaitOptions;
 
     // Enums
     enum class AdapterType : uint32_t
@@ -237,6 +333,19 @@ namespace wgpu
         Inherit         = WGPUCompositeAlphaMode_Inherit,
     };
 
+    enum class CreatePipelineAsyncStatus : uint32_t
+    {
+        Success         = WGPUCreatePipelineAsyncStatus_Success,
+#ifdef WEBGPU_BACKEND_DAWN
+        InstanceDropped = WGPUCreatePipelineAsyncStatus_InstanceDropped,
+#endif
+        ValidationError = WGPUCreatePipelineAsyncStatus_ValidationError,
+        InternalError   = WGPUCreatePipelineAsyncStatus_InternalError,
+        DeviceLost      = WGPUCreatePipelineAsyncStatus_DeviceLost,
+        DeviceDestroyed = WGPUCreatePipelineAsyncStatus_DeviceDestroyed,
+        Unknown         = WGPUCreatePipelineAsyncStatus_Unknown,
+    };
+
     enum class CullMode : uint32_t
     {
 #ifdef WEBGPU_BACKEND_DAWN
@@ -247,6 +356,37 @@ namespace wgpu
         Back      = WGPUCullMode_Back,
     };
 
+    enum class DeviceLostReason : uint32_t
+    {
+#ifdef WEBGPU_BACKEND_DAWN
+        Unknown         = WGPUDeviceLostReason_Unknown,
+#else
+        Undefined       = WGPUDeviceLostReason_Undefined,
+#endif
+        Destroyed       = WGPUDeviceLostReason_Destroyed,
+#ifdef WEBGPU_BACKEND_DAWN
+        InstanceDropped = WGPUDeviceLostReason_InstanceDropped,
+        FailedCreation  = WGPUDeviceLostReason_FailedCreation,
+#endif
+    };
+
+    enum class ErrorFilter : uint32_t
+    {
+        Validation  = WGPUErrorFilter_Validation,
+        OutOfMemory = WGPUErrorFilter_OutOfMemory,
+        Internal    = WGPUErrorFilter_Internal,
+    };
+
+    enum class ErrorType : uint32_t
+    {
+        NoError     = WGPUErrorType_NoError,
+        Validation  = WGPUErrorType_Validation,
+        OutOfMemory = WGPUErrorType_OutOfMemory,
+        Internal    = WGPUErrorType_Internal,
+        Unknown     = WGPUErrorType_Unknown,
+        DeviceLost  = WGPUErrorType_DeviceLost,
+    };
+
     enum class FeatureName : uint32_t
     {
         Undefined                                      = WGPUFeatureName_Undefined,
@@ -316,6 +456,10 @@ namespace wgpu
         YCbCrVulkanSamplers                            = WGPUFeatureName_YCbCrVulkanSamplers,
         ShaderModuleCompilationOptions                 = WGPUFeatureName_ShaderModuleCompilationOptions,
         DawnLoadResolveTexture                         = WGPUFeatureName_DawnLoadResolveTexture,
+#endif
+#ifdef WEBGPU_BACKEND_WGPU
+        MultiDrawIndirect                              = WGPUNativeFeature_MultiDrawIndirect,
+        MultiDrawIndirectCount                         = WGPUNativeFeature_MultiDrawIndirectCount,
 #endif
     };
 
@@ -403,6 +547,23 @@ namespace wgpu
         TriangleStrip = WGPUPrimitiveTopology_TriangleStrip,
     };
 
+    enum class QueryType : uint32_t
+    {
+        Occlusion = WGPUQueryType_Occlusion,
+        Timestamp = WGPUQueryType_Timestamp,
+    };
+
+    enum class QueueWorkDoneStatus : uint32_t
+    {
+        Success         = WGPUQueueWorkDoneStatus_Success,
+#ifdef WEBGPU_BACKEND_DAWN
+        InstanceDropped = WGPUQueueWorkDoneStatus_InstanceDropped,
+#endif
+        Error           = WGPUQueueWorkDoneStatus_Error,
+        Unknown         = WGPUQueueWorkDoneStatus_Unknown,
+        DeviceLost      = WGPUQueueWorkDoneStatus_DeviceLost,
+    };
+
     enum class RequestAdapterStatus : uint32_t
     {
         Success         = WGPURequestAdapterStatus_Success,
@@ -803,345 +964,410 @@ namespace wgpu
         Instance            = WGPUVertexStepMode_Instance,
     };
 
+    enum class WaitStrategy : uint32_t
+    {
+        Sleep,
+        Spin,
+    };
+
     // Callback Types
-    using MapBufferCallback = std::function<void(BufferMapAsyncStatus status)>;
-    using RequestAdapterCallback = std::function<void(RequestAdapterStatus status, const Adapter &adapter,
+    // Lives in DeviceDescriptor, which has to stay copyable, so unlike the others this is a std::function.
+    using DeviceLostCallback = std::function<void(DeviceLostReason reason, const std::string &message)>;
+    using CreateRenderPipelineCallback = InlineFunction<void(CreatePipelineAsyncStatus status,
+        const RenderPipeline &pipeline, const std::string &message)>;
+    using MapBufferCallback = InlineFunction<void(BufferMapAsyncStatus status)>;
+    using PopErrorScopeCallback = InlineFunction<void(ErrorType type, const std::string &message)>;
+    using QueueWorkDoneCallback = InlineFunction<void(QueueWorkDoneStatus status)>;
+    using RequestAdapterCallback = InlineFunction<void(RequestAdapterStatus status, const Adapter &adapter,
         const std::string &message)>;
-    using RequestDeviceCallback = std::function<void(RequestDeviceStatus status, const Device &device,
+    using RequestDeviceCallback = InlineFunction<void(RequestDeviceStatus status, const Device &device,
         const std::string &message)>;
 
-    // RAII Handles
-    class Adapter
+    // RAII Handle Traits
+#ifdef WEBGPU_BACKEND_WGPU
+#define WGPU_CPP_HANDLE_ADD_REF(Name) wgpu##Name##Reference
+#elif WEBGPU_BACKEND_DAWN
+#define WGPU_CPP_HANDLE_ADD_REF(Name) wgpu##Name##AddRef
+#endif
+
+#define WGPU_CPP_HANDLE_TRAITS(Name)                                                                              \
+    template<>                                                                                                    \
+    struct HandleTraits<WGPU##Name>                                                                               \
+    {                                                                                                             \
+        static void add_ref(const WGPU##Name handle) { WGPU_CPP_HANDLE_ADD_REF(Name)(handle); }                   \
+        static void release(const WGPU##Name handle) { wgpu##Name##Release(handle); }                             \
+    };
+
+    WGPU_CPP_HANDLE_TRAITS(Adapter)
+    WGPU_CPP_HANDLE_TRAITS(BindGroup)
+    WGPU_CPP_HANDLE_TRAITS(BindGroupLayout)
+    WGPU_CPP_HANDLE_TRAITS(Buffer)
+    WGPU_CPP_HANDLE_TRAITS(CommandBuffer)
+    WGPU_CPP_HANDLE_TRAITS(CommandEncoder)
+    WGPU_CPP_HANDLE_TRAITS(ComputePassEncoder)
+    WGPU_CPP_HANDLE_TRAITS(ComputePipeline)
+    WGPU_CPP_HANDLE_TRAITS(Device)
+    WGPU_CPP_HANDLE_TRAITS(Instance)
+    WGPU_CPP_HANDLE_TRAITS(PipelineLayout)
+    WGPU_CPP_HANDLE_TRAITS(QuerySet)
+    WGPU_CPP_HANDLE_TRAITS(Queue)
+    WGPU_CPP_HANDLE_TRAITS(RenderBundle)
+    WGPU_CPP_HANDLE_TRAITS(RenderBundleEncoder)
+    WGPU_CPP_HANDLE_TRAITS(RenderPassEncoder)
+    WGPU_CPP_HANDLE_TRAITS(RenderPipeline)
+    WGPU_CPP_HANDLE_TRAITS(Sampler)
+    WGPU_CPP_HANDLE_TRAITS(ShaderModule)
+    WGPU_CPP_HANDLE_TRAITS(Surface)
+    WGPU_CPP_HANDLE_TRAITS(Texture)
+    WGPU_CPP_HANDLE_TRAITS(TextureView)
+
+    // The reference counting shared by every RAII handle. Everything is defined here so that copies, moves and
+    // destruction can be inlined at the call site.
+    template<typename T, typename Traits>
+    class Handle
     {
     public:
-        explicit Adapter(const WGPUAdapter &handle);
-        ~Adapter();
+        Handle() = default;
+        explicit Handle(const T &handle) : m_handle(handle) {}
+
+        ~Handle()
+        {
+            if (m_handle != nullptr)
+            {
+                Traits::release(m_handle);
+            }
+        }
+
+        Handle(const Handle &other) : m_handle(other.m_handle)
+        {
+            if (m_handle != nullptr)
+            {
+                Traits::add_ref(m_handle);
+            }
+        }
+
+        Handle(Handle &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+        Handle & operator=(const Handle &other)
+        {
+            Handle copy{other};
+            std::swap(m_handle, copy.m_handle);
+            return *this;
+        }
+
+        Handle & operator=(Handle &&other) noexcept
+        {
+            std::swap(m_handle, other.m_handle);
+            return *this;
+        }
+
+        [[nodiscard]] T c_ptr() const { return m_handle; }
 
-        Adapter(const Adapter &other);
-        Adapter(Adapter &&other) noexcept;
-        Adapter & operator=(const Adapter &other);
-        Adapter & operator=(Adapter &&other) noexcept;
+    protected:
+        T m_handle{nullptr};
+    };
 
-        [[nodiscard]] WGPUAdapter c_ptr() const;
+    // RAII Handles
+    class Adapter : public Handle<WGPUAdapter>
+    {
+    public:
+        using Handle::Handle;
 
+        // Blocks until the device request completes or wait_options.timeout elapses.
+        [[nodiscard]] std::expected<Device, std::string> create_device(const DeviceDescriptor &descriptor,
+            const WaitOptions &wait_options) const;
         [[nodiscard]] std::expected<Device, std::string> create_device(const DeviceDescriptor &descriptor) const;
         [[nodiscard]] std::vector<FeatureName> enumerate_features() const;
         [[nodiscard]] std::optional<SupportedLimits> get_limits() const;
         [[nodiscard]] std::optional<AdapterProperties> get_properties() const;
         [[nodiscard]] bool has_feature(FeatureName feature) const;
-        [[nodiscard]] std::unique_ptr<RequestDeviceCallback> request_device(const DeviceDescriptor &descriptor,
-            RequestDeviceCallback &&callback) const;
-
-    private:
-        WGPUAdapter m_handle{nullptr};
+        void request_device(const DeviceDescriptor &descriptor, RequestDeviceCallback &&callback) const;
+        [[nodiscard]] DeviceRequestAwaitable request_device(Executor &executor,
+            const DeviceDescriptor &descriptor) const;
     };
 
-    class BindGroup
+    class BindGroup : public Handle<WGPUBindGroup>
     {
     public:
-        explicit BindGroup(const WGPUBindGroup &handle);
-        ~BindGroup();
-
-        BindGroup(const BindGroup &other);
-        BindGroup(BindGroup &&other) noexcept;
-        BindGroup & operator=(const BindGroup &other);
-        BindGroup & operator=(BindGroup &&other) noexcept;
-
-        [[nodiscard]] WGPUBindGroup c_ptr() const;
-
-    private:
-        WGPUBindGroup m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class BindGroupLayout
+    class BindGroupLayout : public Handle<WGPUBindGroupLayout>
     {
     public:
-        explicit BindGroupLayout(const WGPUBindGroupLayout &handle);
-        ~BindGroupLayout();
-
-        BindGroupLayout(const BindGroupLayout &other);
-        BindGroupLayout(BindGroupLayout &&other) noexcept;
-        BindGroupLayout & operator=(const BindGroupLayout &other);
-        BindGroupLayout & operator=(BindGroupLayout &&other) noexcept;
-
-        [[nodiscard]] WGPUBindGroupLayout c_ptr() const;
-
-    private:
-        WGPUBindGroupLayout m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class Buffer
+    class Buffer : public Handle<WGPUBuffer>
     {
     public:
-        explicit Buffer(const WGPUBuffer &handle);
-        ~Buffer();
-
-        Buffer(const Buffer &other);
-        Buffer(Buffer &&other) noexcept;
-        Buffer & operator=(const Buffer &other);
-        Buffer & operator=(Buffer &&other) noexcept;
-
-        [[nodiscard]] WGPUBuffer c_ptr() const;
+        using Handle::Handle;
 
         [[nodiscard]] const void * get_const_mapped_range(size_t offset, size_t size) const;
         template<typename T>
         [[nodiscard]] const T * get_const_mapped_range(size_t offset, size_t count) const;
+        [[nodiscard]] void * get_mapped_range(size_t offset, size_t size) const;
+        template<typename T>
+        [[nodiscard]] T * get_mapped_range(size_t offset, size_t count) const;
         [[nodiscard]] uint64_t get_size() const;
-        [[nodiscard]] std::unique_ptr<MapBufferCallback> map_async(MapModeFlags mode, size_t offset, size_t size,
-            MapBufferCallback &&callback) const;
+        void map_async(MapModeFlags mode, size_t offset, size_t size, MapBufferCallback &&callback) const;
+        [[nodiscard]] BufferMapAwaitable map_async(Executor &executor, MapModeFlags mode, size_t offset,
+            size_t size) const;
         void unmap() const;
-
-    private:
-        WGPUBuffer m_handle{nullptr};
     };
 
-    class CommandBuffer
+    class CommandBuffer : public Handle<WGPUCommandBuffer>
     {
     public:
-        explicit CommandBuffer(const WGPUCommandBuffer &handle);
-        ~CommandBuffer();
-
-        CommandBuffer(const CommandBuffer &other);
-        CommandBuffer(CommandBuffer &&other) noexcept;
-        CommandBuffer & operator=(const CommandBuffer &other);
-        CommandBuffer & operator=(CommandBuffer &&other) noexcept;
-
-        [[nodiscard]] WGPUCommandBuffer c_ptr() const;
-
-    private:
-        WGPUCommandBuffer m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class CommandEncoder
+    class CommandEncoder : public Handle<WGPUCommandEncoder>
     {
     public:
-        explicit CommandEncoder(const WGPUCommandEncoder &handle);
-        ~CommandEncoder();
-
-        CommandEncoder(const CommandEncoder &other);
-        CommandEncoder(CommandEncoder &&other) noexcept;
-        CommandEncoder & operator=(const CommandEncoder &other);
-        CommandEncoder & operator=(CommandEncoder &&other) noexcept;
-
-        [[nodiscard]] WGPUCommandEncoder c_ptr() const;
+        using Handle::Handle;
 
+        [[nodiscard]] ComputePassEncoder begin_compute_pass(const ComputePassDescriptor &descriptor) const;
         [[nodiscard]] RenderPassEncoder begin_render_pass(const RenderPassDescriptor &descriptor) const;
         void copy_buffer_to_buffer(const Buffer &source, uint64_t source_offset, const Buffer &destination,
             uint64_t destination_offset, uint64_t size) const;
         [[nodiscard]] CommandBuffer finish(const CommandBufferDescriptor &descriptor) const;
+        void resolve_query_set(const QuerySet &query_set, uint32_t first_query, uint32_t query_count,
+            const Buffer &destination, uint64_t destination_offset) const;
+        void write_timestamp(const QuerySet &query_set, uint32_t query_index) const;
+    };
 
-    private:
-        WGPUCommandEncoder m_handle{nullptr};
+    class ComputePassEncoder : public Handle<WGPUComputePassEncoder>
+    {
+    public:
+        using Handle::Handle;
+
+        void dispatch_workgroups(uint32_t workgroup_count_x, uint32_t workgroup_count_y,
+            uint32_t workgroup_count_z) const;
+        void dispatch_workgroups_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset) const;
+        void end() const;
+        void set_bind_group(uint32_t group_index, const BindGroup &group,
+            std::span<const uint32_t> dynamic_offsets = {}) const;
+        void set_bind_group(uint32_t group_index, const BindGroup &group,
+            std::initializer_list<uint32_t> dynamic_offsets) const;
+        void set_pipeline(const ComputePipeline &pipeline) const;
     };
 
-    class Device
+    class ComputePipeline : public Handle<WGPUComputePipeline>
     {
     public:
-        explicit Device(const WGPUDevice &handle);
-        ~Device();
+        using Handle::Handle;
 
-        Device(const Device &other);
-        Device(Device &&other) noexcept;
-        Device & operator=(const Device &other);
-        Device & operator=(Device &&other) noexcept;
+        [[nodiscard]] BindGroupLayout get_bind_group_layout(uint32_t group_index) const;
+    };
 
-        [[nodiscard]] WGPUDevice c_ptr() const;
+    class Device : public Handle<WGPUDevice>
+    {
+    public:
+        using Handle::Handle;
 
         [[nodiscard]] BindGroup create_bind_group(const BindGroupDescriptor &descriptor) const;
         [[nodiscard]] BindGroupLayout create_bind_group_layout(const BindGroupLayoutDescriptor &descriptor) const;
         [[nodiscard]] Buffer create_buffer(const BufferDescriptor &descriptor) const;
         [[nodiscard]] CommandEncoder create_command_encoder(const CommandEncoderDescriptor &descriptor) const;
+        [[nodiscard]] ComputePipeline create_compute_pipeline(const ComputePipelineDescriptor &descriptor) const;
         [[nodiscard]] PipelineLayout create_pipeline_layout(const PipelineLayoutDescriptor &descriptor) const;
+        [[nodiscard]] QuerySet create_query_set(const QuerySetDescriptor &descriptor) const;
+        [[nodiscard]] RenderBundleEncoder create_render_bundle_encoder(
+            const RenderBundleEncoderDescriptor &descriptor) const;
         [[nodiscard]] RenderPipeline create_render_pipeline(const RenderPipelineDescriptor &descriptor) const;
+        // Compiles the pipeline without blocking. The descriptor is copied and its layout and shader modules are
+        // referenced, so only its chained structs have to outlive the call.
+        // On Dawn the callback fires from Instance::process_events; wgpu-native has no asynchronous pipeline
+        // creation, so there the pipeline is created on a library-owned worker thread inside a validation error
+        // scope, and the callback fires from that thread with ValidationError if creation failed.
+        void create_render_pipeline_async(const RenderPipelineDescriptor &descriptor,
+            CreateRenderPipelineCallback &&callback) const;
+        [[nodiscard]] AsyncRenderPipeline create_render_pipeline_async(
+            const RenderPipelineDescriptor &descriptor) const;
+        [[nodiscard]] RenderPipelineCreateAwaitable create_render_pipeline_async(Executor &executor,
+            const RenderPipelineDescriptor &descriptor) const;
         [[nodiscard]] Sampler create_sampler(const SamplerDescriptor &descriptor) const;
         [[nodiscard]] ShaderModule create_shader_module(const ShaderModuleDescriptor &descriptor) const;
         [[nodiscard]] Texture create_texture(const TextureDescriptor &descriptor) const;
         [[nodiscard]] std::optional<SupportedLimits> get_limits() const;
         [[nodiscard]] Queue get_queue() const;
+        // Resolves the innermost error scope with the first error it captured, or ErrorType::NoError.
+        // On wgpu-native, where a device's scopes are shared by every thread, pushes and pops are serialized with
+        // the validation scopes the library opens around pipeline creation, so the two always nest. Errors that
+        // other threads raise while such a scope is open are still captured by it, though.
+        void pop_error_scope(PopErrorScopeCallback &&callback) const;
+        [[nodiscard]] ErrorScopeAwaitable pop_error_scope(Executor &executor) const;
+        void push_error_scope(ErrorFilter filter) const;
         void tick() const;
-
-    private:
-        WGPUDevice m_handle{nullptr};
-    };
-
-    class Instance
+        // Compiles every pipeline concurrently and reports how long each took. wgpu-native devices are thread
+        // safe, so the pool's workers create them directly, inside a validation error scope that reports failed
+        // descriptors the way create_render_pipeline_async does. On Dawn every pipeline goes through
+        // create_render_pipeline_async instead, which Dawn compiles on its own workers, so the pool is unused and
+        // a compile time runs from the request to its callback. It therefore includes any time the pipeline spent
+        // queued behind the others, not just its compilation. wait_options bounds the whole warm-up on Dawn, which
+        // processes the device's instance events while it waits; pipelines still compiling when it expires are
+        // reported as timed out.
+        [[nodiscard]] PipelineWarmUpResult warm_up_render_pipelines(
+            std::span<const RenderPipelineDescriptor> descriptors, ThreadPool &pool,
+            const WaitOptions &wait_options) const;
+        [[nodiscard]] PipelineWarmUpResult warm_up_render_pipelines(
+            std::span<const RenderPipelineDescriptor> descriptors, ThreadPool &pool) const;
+    };
+
+    class Instance : public Handle<WGPUInstance>
     {
     public:
-        explicit Instance(const WGPUInstance &handle);
-        ~Instance();
-
-        Instance(const Instance &other);
-        Instance(Instance &&other) noexcept;
-        Instance & operator=(const Instance &other);
-        Instance & operator=(Instance &&other) noexcept;
-
-        [[nodiscard]] WGPUInstance c_ptr() const;
+        using Handle::Handle;
 
+        // Blocks until the adapter request completes or wait_options.timeout elapses.
+        [[nodiscard]] std::expected<Adapter, std::string> create_adapter(const RequestAdapterOptions &options,
+            const WaitOptions &wait_options) const;
         [[nodiscard]] std::expected<Adapter, std::string> create_adapter(const RequestAdapterOptions &options) const;
         void process_events() const;
-        [[nodiscard]] std::unique_ptr<RequestAdapterCallback> request_adapter(const RequestAdapterOptions &options,
-            RequestAdapterCallback &&callback) const;
-
-    private:
-        WGPUInstance m_handle{nullptr};
+        void request_adapter(const RequestAdapterOptions &options, RequestAdapterCallback &&callback) const;
+        [[nodiscard]] AdapterRequestAwaitable request_adapter(Executor &executor,
+            const RequestAdapterOptions &options) const;
     };
 
-    class PipelineLayout
+    class PipelineLayout : public Handle<WGPUPipelineLayout>
     {
     public:
-        explicit PipelineLayout(const WGPUPipelineLayout &handle);
-        ~PipelineLayout();
-
-        PipelineLayout(const PipelineLayout &other);
-        PipelineLayout(PipelineLayout &&other) noexcept;
-        PipelineLayout & operator=(const PipelineLayout &other);
-        PipelineLayout & operator=(PipelineLayout &&other) noexcept;
-
-        [[nodiscard]] WGPUPipelineLayout c_ptr() const;
-
-    private:
-        WGPUPipelineLayout m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class Queue
+    class QuerySet : public Handle<WGPUQuerySet>
     {
     public:
-        explicit Queue(const WGPUQueue &handle);
-        ~Queue();
+        using Handle::Handle;
 
-        Queue(const Queue &other);
-        Queue(Queue &&other) noexcept;
-        Queue & operator=(const Queue &other);
-        Queue & operator=(Queue &&other) noexcept;
+        void destroy() const;
+        [[nodiscard]] uint32_t get_count() const;
+        [[nodiscard]] QueryType get_type() const;
+    };
 
-        [[nodiscard]] WGPUQueue c_ptr() const;
+    class Queue : public Handle<WGPUQueue>
+    {
+    public:
+        using Handle::Handle;
 
-        void submit(const std::vector<CommandBuffer> &commands) const;
+        // Called or completed once all work submitted to the queue before the call has finished on the GPU.
+        void on_submitted_work_done(QueueWorkDoneCallback &&callback) const;
+        [[nodiscard]] QueueWorkDoneAwaitable on_submitted_work_done(Executor &executor) const;
+        void submit(std::span<const CommandBuffer> commands) const;
+        void submit(std::initializer_list<CommandBuffer> commands) const;
         template<typename T>
         void write_buffer(const Buffer &buffer, uint64_t buffer_offset, const T &data) const;
+        template<typename T, size_t Extent>
+        void write_buffer(const Buffer &buffer, uint64_t buffer_offset, std::span<T, Extent> data) const;
         template<typename T>
         void write_buffer(const Buffer &buffer, uint64_t buffer_offset, const std::vector<T> &data) const;
+        template<typename T, size_t Extent>
+        void write_texture(const ImageCopyTexture &destination, std::span<T, Extent> data,
+            const TextureDataLayout &data_layout, const Extent3D &write_size) const;
         template<typename T>
-        void write_texture(const ImageCopyTexture &destination, const std::vector<T> &data, const TextureDataLayout &data_layout, const Extent3D &write_size) const;
-
+        void write_texture(const ImageCopyTexture &destination, const std::vector<T> &data,
+            const TextureDataLayout &data_layout, const Extent3D &write_size) const;
+    };
 
-    private:
-        WGPUQueue m_handle{nullptr};
+    class RenderBundle : public Handle<WGPURenderBundle>
+    {
+    public:
+        using Handle::Handle;
     };
 
-    class RenderPassEncoder
+    class RenderBundleEncoder : public Handle<WGPURenderBundleEncoder>
     {
     public:
-        explicit RenderPassEncoder(const WGPURenderPassEncoder &handle);
-        ~RenderPassEncoder();
+        using Handle::Handle;
 
-        RenderPassEncoder(const RenderPassEncoder &other);
-        RenderPassEncoder(RenderPassEncoder &&other) noexcept;
-        RenderPassEncoder & operator=(const RenderPassEncoder &other);
-        RenderPassEncoder & operator=(RenderPassEncoder &&other) noexcept;
+        void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) const;
+        void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t base_vertex,
+            uint32_t first_instance) const;
+        void draw_indexed_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset) const;
+        void draw_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset) const;
+        [[nodiscard]] RenderBundle finish(const RenderBundleDescriptor &descriptor) const;
+        void set_bind_group(uint32_t group_index, const BindGroup &group,
+            std::span<const uint32_t> dynamic_offsets = {}) const;
+        void set_bind_group(uint32_t group_index, const BindGroup &group,
+            std::initializer_list<uint32_t> dynamic_offsets) const;
+        void set_index_buffer(const Buffer &buffer, IndexFormat format, uint64_t offset, uint64_t size) const;
+        void set_index_buffer(const BufferSlice &slice, IndexFormat format) const;
+        void set_pipeline(const RenderPipeline &pipeline) const;
+        void set_vertex_buffer(uint32_t slot, const Buffer &buffer, uint64_t offset, uint64_t size) const;
+        void set_vertex_buffer(uint32_t slot, const BufferSlice &slice) const;
+    };
 
-        [[nodiscard]] WGPURenderPassEncoder c_ptr() const;
+    class RenderPassEncoder : public Handle<WGPURenderPassEncoder>
+    {
+    public:
+        using Handle::Handle;
 
         void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) const;
         void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t base_vertex,
             uint32_t first_instance) const;
+        void draw_indexed_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset) const;
+        void draw_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset) const;
         void end() const;
+        void execute_bundles(std::span<const RenderBundle> bundles) const;
+        void execute_bundles(std::initializer_list<RenderBundle> bundles) const;
+        // On wgpu-native these map to its multi-draw calls, which require the device to have been created with
+        // FeatureName::MultiDrawIndirect. Dawn has no multi-draw, so there they issue one indirect draw per
+        // tightly packed argument struct.
+        void multi_draw_indexed_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset, uint32_t count) const;
+        void multi_draw_indirect(const Buffer &indirect_buffer, uint64_t indirect_offset, uint32_t count) const;
+#ifdef WEBGPU_BACKEND_WGPU
+        // Require FeatureName::MultiDrawIndirectCount.
+        void multi_draw_indexed_indirect_count(const Buffer &indirect_buffer, uint64_t indirect_offset,
+            const Buffer &count_buffer, uint64_t count_buffer_offset, uint32_t max_count) const;
+        void multi_draw_indirect_count(const Buffer &indirect_buffer, uint64_t indirect_offset,
+            const Buffer &count_buffer, uint64_t count_buffer_offset, uint32_t max_count) const;
+#endif
+        void set_bind_group(uint32_t group_index, const BindGroup &group,
+            std::span<const uint32_t> dynamic_offsets = {}) const;
         void set_bind_group(uint32_t group_index, const BindGroup &group,
-            const std::vector<uint32_t> &dynamic_offsets = {}) const;
+            std::initializer_list<uint32_t> dynamic_offsets) const;
         void set_index_buffer(const Buffer &buffer, IndexFormat format, uint64_t offset, uint64_t size) const;
+        void set_index_buffer(const BufferSlice &slice, IndexFormat format) const;
         void set_pipeline(const RenderPipeline &pipeline) const;
         void set_vertex_buffer(uint32_t slot, const Buffer &buffer, uint64_t offset, uint64_t size) const;
-
-    private:
-        WGPURenderPassEncoder m_handle{nullptr};
+        void set_vertex_buffer(uint32_t slot, const BufferSlice &slice) const;
     };
 
-    class RenderPipeline
+    class RenderPipeline : public Handle<WGPURenderPipeline>
     {
     public:
-        explicit RenderPipeline(const WGPURenderPipeline &handle);
-        ~RenderPipeline();
-
-        RenderPipeline(const RenderPipeline &other);
-        RenderPipeline(RenderPipeline &&other) noexcept;
-        RenderPipeline & operator=(const RenderPipeline &other);
-        RenderPipeline & operator=(RenderPipeline &&other) noexcept;
-
-        [[nodiscard]] WGPURenderPipeline c_ptr() const;
-
-    private:
-        WGPURenderPipeline m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class Sampler
+    class Sampler : public Handle<WGPUSampler>
     {
     public:
-        explicit Sampler(const WGPUSampler &handle);
-        ~Sampler();
-
-        Sampler(const Sampler &other);
-        Sampler(Sampler &&other) noexcept;
-        Sampler & operator=(const Sampler &other);
-        Sampler & operator=(Sampler &&other) noexcept;
-
-        [[nodiscard]] WGPUSampler c_ptr() const;
-
-    private:
-        WGPUSampler m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class ShaderModule
+    class ShaderModule : public Handle<WGPUShaderModule>
     {
     public:
-        explicit ShaderModule(const WGPUShaderModule &handle);
-        ~ShaderModule();
-
-        ShaderModule(const ShaderModule &other);
-        ShaderModule(ShaderModule &&other) noexcept;
-        ShaderModule & operator=(const ShaderModule &other);
-        ShaderModule & operator=(ShaderModule &&other) noexcept;
-
-        [[nodiscard]] WGPUShaderModule c_ptr() const;
-
-    private:
-        WGPUShaderModule m_handle{nullptr};
+        using Handle::Handle;
     };
 
-    class Surface
+    class Surface : public Handle<WGPUSurface>
     {
     public:
-        explicit Surface(const WGPUSurface &handle);
-        ~Surface();
-
-        Surface(const Surface &other);
-        Surface(Surface &&other) noexcept;
-        Surface & operator=(const Surface &other);
-        Surface & operator=(Surface &&other) noexcept;
-
-        [[nodiscard]] WGPUSurface c_ptr() const;
+        using Handle::Handle;
 
         void configure(const SurfaceConfiguration &configuration) const;
         [[nodiscard]] SurfaceCapabilities get_capabilities(const Adapter &adapter) const;
         [[nodiscard]] SurfaceTexture get_current_texture() const;
         void present() const;
         void unconfigure() const;
-
-    private:
-        WGPUSurface m_handle{nullptr};
     };
 
-    class Texture
+    class Texture : public Handle<WGPUTexture>
     {
     public:
-        explicit Texture(const WGPUTexture &handle);
-        ~Texture();
-
-        Texture(const Texture &other);
-        Texture(Texture &&other) noexcept;
-        Texture & operator=(const Texture &other);
-        Texture & operator=(Texture &&other) noexcept;
-
-        [[nodiscard]] WGPUTexture c_ptr() const;
+        using Handle::Handle;
 
         [[nodiscard]] TextureView create_view() const;
         [[nodiscard]] TextureView create_view(const TextureViewDescriptor &descriptor) const;
@@ -1153,165 +1379,1479 @@ namespace wgpu
         [[nodiscard]] uint32_t get_sample_count() const;
         [[nodiscard]] TextureUsageFlags get_usage() const;
         [[nodiscard]] uint32_t get_width() const;
-
-    private:
-        WGPUTexture m_handle{nullptr};
     };
 
-    class TextureView
+    class TextureView : public Handle<WGPUTextureView>
     {
     public:
+        TextureView() = default;
         explicit TextureView(const WGPUTexture &texture, const WGPUTextureView &handle);
-        ~TextureView();
-
-        TextureView(const TextureView &other);
-        TextureView(TextureView &&other) noexcept;
-        TextureView & operator=(const TextureView &other);
-        TextureView & operator=(TextureView &&other) noexcept;
-
-        [[nodiscard]] WGPUTextureView c_ptr() const;
 
     private:
         // On WGPU, WGPUTextureView needs its WGPUTexture to stick around. Otherwise it fails.
-        WGPUTexture m_texture{nullptr};
-        WGPUTextureView m_handle{nullptr};
+        Texture m_texture;
     };
 
-    // Structs
-    struct AdapterProperties
-    {
-        ChainedStructOut *next_in_chain;
-        uint32_t vendor_id;
-        std::string vendor_name;
-        std::string architecture;
-        uint32_t device_id;
-        std::string name;
-        std::string driver_description;
-        AdapterType adapter_type;
-        BackendType backend_type;
-    };
+    // Non-owning Handle References
 
-    struct BindGroupDescriptor
+    // A borrowed view of a RAII handle for use in descriptors. Making or copying one never touches the
+    // handle's reference count, so it is only valid for as long as the handle it was made from.
+    template<typename T, typename C>
+    class HandleRef
     {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-        BindGroupLayout layout;
-        std::vector<BindGroupEntry> entries;
-    };
+    public:
+        constexpr HandleRef() = default;
+        constexpr HandleRef(std::nullopt_t) {}
+        HandleRef(const T &handle) : m_handle(handle.c_ptr()) {}
+        constexpr explicit HandleRef(C handle) : m_handle(handle) {}
 
-    struct BindGroupEntry
-    {
-        const ChainedStruct *next_in_chain;
-        uint32_t binding;
-        std::optional<Buffer> buffer;
-        uint64_t offset;
-        uint64_t size;
-        std::optional<Sampler> sampler;
-        std::optional<TextureView> texture_view;
-    };
+        [[nodiscard]] constexpr C c_ptr() const { return m_handle; }
+        [[nodiscard]] constexpr explicit operator bool() const { return m_handle != nullptr; }
 
-    struct BindGroupLayoutDescriptor
-    {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-        std::vector<BindGroupLayoutEntry> entries;
+    private:
+        C m_handle{nullptr};
     };
 
-    struct BufferBindingLayout
-    {
-        const ChainedStruct *next_in_chain;
-        BufferBindingType type;
-        bool has_dynamic_offset;
-        uint64_t min_binding_size;
-    };
+    // Utilities
 
-    struct BufferDescriptor
+    // A bump allocator used to translate descriptors into their C equivalents without touching the heap.
+    // Every translation path allocates from the calling thread's arena inside a FrameArenaScope, so
+    // the memory is handed back as soon as the call returns. Calling reset() once per frame folds any
+    // overflow blocks into one, after which translation makes no heap allocations. Building the C++
+    // descriptors themselves still can, since members such as RenderPassDescriptor::color_attachments and
+    // BindGroupDescriptor::entries are vectors.
+    class FrameArena
     {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-        BufferUsageFlags usage;
-        uint64_t size;
-        bool mapped_at_creation;
-    };
+    public:
+        explicit FrameArena(size_t block_size = 64 * 1024);
 
-    struct ChainedStruct
-    {
-        const ChainedStruct *next_in_chain;
-        SType s_type;
-    };
+        FrameArena(const FrameArena &other) = delete;
+        FrameArena(FrameArena &&other) noexcept = default;
+        FrameArena & operator=(const FrameArena &other) = delete;
+        FrameArena & operator=(FrameArena &&other) noexcept = default;
 
-    struct ChainedStructOut
-    {
-        ChainedStructOut *next_in_chain;
-        SType s_type;
-    };
+        [[nodiscard]] static FrameArena & get_thread_local();
 
-    struct Color
-    {
-        double r;
-        double g;
-        double b;
-        double a;
-    };
+        template<typename T>
+        [[nodiscard]] std::span<T> allocate(size_t count);
+        [[nodiscard]] void * allocate_bytes(size_t size, size_t alignment);
+        void reset();
 
-    struct CommandBufferDescriptor
-    {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-    };
+        [[nodiscard]] size_t get_bytes_used() const;
+        [[nodiscard]] size_t get_capacity() const;
+        // The number of blocks this arena has requested from the heap over its lifetime. Only the arena's own
+        // blocks are counted, not allocations made elsewhere, such as while building descriptors.
+        [[nodiscard]] uint64_t get_heap_allocation_count() const;
 
-    struct CommandEncoderDescriptor
-    {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-    };
+    private:
+        friend class FrameArenaScope;
 
-    struct ConstantEntry
-    {
-        const ChainedStruct *next_in_chain;
-        std::string key;
-        double value;
-    };
+        struct Block
+        {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
 
-    struct QueueDescriptor
-    {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-    };
+        struct Marker
+        {
+            size_t block;
+            size_t offset;
+        };
 
-    struct DeviceDescriptor
-    {
-        const ChainedStruct *next_in_chain;
-        std::string label;
-        std::vector<FeatureName> required_features;
-        WGPU_NULLABLE const RequiredLimits *required_limits;
-        QueueDescriptor default_queue;
+        std::vector<Block> m_blocks;
+        size_t m_block_size;
+        size_t m_current_block{0};
+        size_t m_offset{0};
+        uint64_t m_heap_allocation_count{0};
     };
 
-    struct Extent3D
+    // Rewinds a FrameArena to where it was when the scope was opened.
+    class FrameArenaScope
     {
-        uint32_t width;
-        uint32_t height;
-        uint32_t depth_or_array_layers;
-    };
+    public:
+        explicit FrameArenaScope(FrameArena &arena);
+        ~FrameArenaScope();
 
-    struct FragmentState
-    {
-        const ChainedStruct *next_in_chain;
-        ShaderModule module;
-        std::optional<std::string> entry_point;
-        std::vector<ConstantEntry> constants;
-        std::vector<ColorTargetState> targets;
-    };
+        FrameArenaScope(const FrameArenaScope &other) = delete;
+        FrameArenaScope & operator=(const FrameArenaScope &other) = delete;
 
-#ifdef WEBGPU_BACKEND_DAWN
-    struct InstanceFeatures
-    {
-        const ChainedStruct *next_in_chain;
-        bool timed_wait_any_enable;
-        size_t timed_wait_any_max_count;
+    private:
+        FrameArena &m_arena;
+        FrameArena::Marker m_marker;
     };
-#endif
+
+    // A move-only callable that keeps callables of up to Capacity bytes inline and only puts larger ones on the
+    // heap. The asynchronous callback types use it, so a lambda capturing a few references never allocates.
+    template<typename R, typename... Args, size_t Capacity>
+    class InlineFunction<R(Args...), Capacity>
+    {
+    public:
+        InlineFunction() = default;
+        InlineFunction(std::nullptr_t) {}
+
+        template<typename F>
+            requires (!std::is_same_v<std::remove_cvref_t<F>, InlineFunction>
+                && std::is_invocable_r_v<R, std::decay_t<F> &, Args...>)
+        InlineFunction(F &&function)
+        {
+            using Stored = std::decay_t<F>;
+            if constexpr (fits_inline<Stored>)
+            {
+                ::new (static_cast<void *>(m_storage)) Stored(std::forward<F>(function));
+            }
+            else
+            {
+                ::new (static_cast<void *>(m_storage)) Stored *(new Stored(std::forward<F>(function)));
+            }
+            m_vtable = &vtable_for<Stored>;
+        }
+
+        ~InlineFunction()
+        {
+            reset();
+        }
+
+        InlineFunction(const InlineFunction &other) = delete;
+        InlineFunction(InlineFunction &&other) noexcept
+        {
+            move_from(other);
+        }
+
+        InlineFunction & operator=(const InlineFunction &other) = delete;
+        InlineFunction & operator=(InlineFunction &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        R operator()(Args... args)
+        {
+            return m_vtable->invoke(m_storage, std::forward<Args>(args)...);
+        }
+
+        explicit operator bool() const
+        {
+            return m_vtable != nullptr;
+        }
+
+    private:
+        static_assert(Capacity >= sizeof(void *));
+
+        struct VTable
+        {
+            R (*invoke)(std::byte *storage, Args &&...args);
+            void (*move)(std::byte *destination, std::byte *source);
+            void (*destroy)(std::byte *storage);
+        };
+
+        template<typename F>
+        static constexpr bool fits_inline = sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<F>;
+
+        template<typename F>
+        static F * get(std::byte *storage)
+        {
+            if constexpr (fits_inline<F>)
+            {
+                return std::launder(reinterpret_cast<F *>(storage));
+            }
+            else
+            {
+                return *std::launder(reinterpret_cast<F **>(storage));
+            }
+        }
+
+        template<typename F>
+        static constexpr VTable vtable_for
+        {
+            .invoke = [](std::byte *storage, Args &&...args) -> R
+            {
+                return std::invoke(*get<F>(storage), std::forward<Args>(args)...);
+            },
+            .move = [](std::byte *destination, std::byte *source)
+            {
+                if constexpr (fits_inline<F>)
+                {
+                    ::new (static_cast<void *>(destination)) F(std::move(*get<F>(source)));
+                    get<F>(source)->~F();
+                }
+                else
+                {
+                    ::new (static_cast<void *>(destination)) F *(get<F>(source));
+                }
+            },
+            .destroy = [](std::byte *storage)
+            {
+                if constexpr (fits_inline<F>)
+                {
+                    get<F>(storage)->~F();
+                }
+                else
+                {
+                    delete get<F>(storage);
+                }
+            },
+        };
+
+        void reset()
+        {
+            if (m_vtable)
+            {
+                m_vtable->destroy(m_storage);
+                m_vtable = nullptr;
+            }
+        }
+
+        void move_from(InlineFunction &other)
+        {
+            if (other.m_vtable)
+            {
+                other.m_vtable->move(m_storage, other.m_storage);
+                m_vtable = std::exchange(other.m_vtable, nullptr);
+            }
+        }
+
+        alignas(std::max_align_t) std::byte m_storage[Capacity];
+        const VTable *m_vtable{nullptr};
+    };
+
+    // Owns the storage of in-flight asynchronous callbacks. Slots are carved from fixed-size slabs and recycled
+    // through a free list. Once the pool has grown to the peak number of operations in flight, issuing another
+    // one allocates nothing. A buffer cannot name its device, so one pool serves the whole process.
+    class CallbackPool
+    {
+    public:
+        static constexpr size_t slot_size = 96;
+        static constexpr size_t slots_per_slab = 256;
+
+        CallbackPool() = default;
+
+        CallbackPool(const CallbackPool &other) = delete;
+        CallbackPool & operator=(const CallbackPool &other) = delete;
+
+        [[nodiscard]] static CallbackPool & get();
+
+        [[nodiscard]] void * allocate();
+        void deallocate(void *slot);
+
+        [[nodiscard]] size_t get_capacity() const;
+        [[nodiscard]] size_t get_in_flight_count() const;
+
+    private:
+        union Slot
+        {
+            Slot *next;
+            alignas(std::max_align_t) std::byte storage[slot_size];
+        };
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<Slot[]>> m_slabs;
+        Slot *m_free_list{nullptr};
+        size_t m_in_flight_count{0};
+    };
+
+    // Collects a device's uncaptured errors without blocking the thread that reports them. Set it as
+    // DeviceDescriptor::error_sink and drain it with try_pop wherever is convenient, such as once per frame.
+    // Errors go into a bounded lock-free ring of fixed-size entries, so reporting one never allocates or locks.
+    // Messages longer than max_message_length are truncated, and errors arriving while the ring is full are
+    // counted and dropped. Without a sink, uncaptured errors are printed to std::cerr. The sink must outlive
+    // every device it is set on.
+    class ErrorSink
+    {
+    public:
+        static constexpr size_t max_message_length = 256;
+
+        // The capacity is rounded up to a power of two.
+        explicit ErrorSink(size_t capacity = 64);
+
+        ErrorSink(const ErrorSink &other) = delete;
+        ErrorSink & operator=(const ErrorSink &other) = delete;
+
+        // Returns false, and counts the error as dropped, if the ring is full.
+        bool push(ErrorType type, std::string_view message);
+        [[nodiscard]] std::optional<DeviceError> try_pop();
+
+        [[nodiscard]] size_t get_capacity() const;
+        [[nodiscard]] uint64_t get_dropped_count() const;
+
+    private:
+        // Each cell's sequence says whose turn it is: it equals the position a producer may write at, and that
+        // position plus one once the entry is ready for a consumer.
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            ErrorType type;
+            size_t message_length;
+            char message[max_message_length];
+        };
+
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask;
+        alignas(64) std::atomic<size_t> m_enqueue_position{0};
+        alignas(64) std::atomic<size_t> m_dequeue_position{0};
+        std::atomic<uint64_t> m_dropped_count{0};
+    };
+
+    // A borrowed, null-terminated descriptor label. It holds only a pointer, so descriptors built every frame do
+    // not construct strings, and it must not outlive the string it was made from, so it cannot be made from a
+    // temporary std::string. When WGPU_CPP_STRIP_LABELS is defined, labels are dropped entirely and every
+    // descriptor passes nullptr.
+    class Label
+    {
+    public:
+        constexpr Label() = default;
+#ifdef WGPU_CPP_STRIP_LABELS
+        constexpr Label(const char *) {}
+        Label(const std::string &) {}
+        Label(std::string &&) = delete;
+
+        [[nodiscard]] constexpr const char * c_str() const { return nullptr; }
+#else
+        constexpr Label(const char *label) : m_label(label) {}
+        Label(const std::string &label) : m_label(label.c_str()) {}
+        Label(std::string &&) = delete;
+
+        [[nodiscard]] constexpr const char * c_str() const { return m_label; }
+
+    private:
+        const char *m_label{nullptr};
+#endif
+    };
+
+    // Sub-allocates vertex, index and storage data out of a few large buffers, so thousands of meshes share a
+    // handful of buffer objects instead of owning one each. Free ranges are kept in two-level segregated fit
+    // (TLSF) lists, which makes allocate and free O(1): a size maps to a list through its highest set bits, and
+    // bitmaps find the first non-empty list that is large enough. Freed ranges merge with free neighbours in
+    // the same buffer. When nothing fits, another buffer of page_size bytes, or of the request's size if that is
+    // larger, is created with the allocator's usage. Not thread safe.
+    class BufferAllocator
+    {
+    public:
+        BufferAllocator(const Device &device, BufferUsageFlags usage, uint64_t page_size = 64 * 1024 * 1024);
+
+        BufferAllocator(const BufferAllocator &other) = delete;
+        BufferAllocator & operator=(const BufferAllocator &other) = delete;
+
+        // The alignment must be a power of two. Returns std::nullopt for empty requests or invalid alignments.
+        [[nodiscard]] std::optional<BufferAllocation> allocate(uint64_t size, uint64_t alignment = 4);
+        void free(const BufferAllocation &allocation);
+
+        [[nodiscard]] BufferAllocatorStatistics get_statistics() const;
+
+    private:
+        static constexpr uint32_t second_level_log2 = 5;
+        static constexpr uint32_t second_level_count = 1 << second_level_log2;
+        static constexpr uint32_t first_level_count = 64 - second_level_log2 + 1;
+        static constexpr uint32_t null_node = UINT32_MAX;
+
+        // A range of a page. Physical links run through the page in address order; free links run through the
+        // range's free list.
+        struct Node
+        {
+            uint64_t offset;
+            uint64_t size;
+            uint32_t page;
+            uint32_t previous_physical;
+            uint32_t next_physical;
+            uint32_t previous_free;
+            uint32_t next_free;
+            bool free;
+        };
+
+        struct ListIndex
+        {
+            uint32_t first_level;
+            uint32_t second_level;
+        };
+
+        [[nodiscard]] static ListIndex get_list_index(uint64_t size);
+        [[nodiscard]] uint32_t find_free_node(uint64_t size) const;
+        void insert_free_node(uint32_t node);
+        void remove_free_node(uint32_t node);
+        void merge_with_next(uint32_t node);
+        uint32_t split_node(uint32_t node, uint64_t size);
+        uint32_t create_node(const Node &node);
+        void destroy_node(uint32_t node);
+        uint32_t add_page(uint64_t size);
+
+        Device m_device;
+        BufferUsageFlags m_usage;
+        uint64_t m_page_size;
+        std::vector<Buffer> m_pages;
+        std::vector<Node> m_nodes;
+        uint32_t m_unused_nodes{null_node};
+        uint64_t m_first_level_bitmap{0};
+        std::array<uint32_t, first_level_count> m_second_level_bitmaps{};
+        std::array<std::array<uint32_t, second_level_count>, first_level_count> m_free_lists;
+        uint64_t m_allocated_bytes{0};
+        size_t m_allocation_count{0};
+    };
+
+    // A render pipeline that is still being compiled. Rendering code can draw with get_or(placeholder) every
+    // frame and switches to the real pipeline as soon as it is ready, so new materials stream in without a
+    // hitch. Copies share the same pending result.
+    class AsyncRenderPipeline
+    {
+    public:
+        AsyncRenderPipeline();
+
+        [[nodiscard]] bool is_ready() const;
+        // Returns the pipeline, the creation error, or an error saying the pipeline is still compiling.
+        [[nodiscard]] std::expected<RenderPipeline, std::string> get() const;
+        [[nodiscard]] const RenderPipeline & get_or(const RenderPipeline &placeholder) const;
+
+    private:
+        friend class Device;
+
+        struct State
+        {
+            std::atomic<bool> ready{false};
+            std::expected<RenderPipeline, std::string> result;
+        };
+
+        std::shared_ptr<State> m_state;
+    };
+
+    // Submits through a queue and numbers each submission with a monotonically increasing serial, starting at 1.
+    // A serial is complete once the GPU has finished its submission and every one before it, which makes it the
+    // basis for frames-in-flight limits and deciding when a resource can be reused. The queue reports
+    // completions in submission order, so tracking one needs just a counter. The tracker must outlive every
+    // submission it has made that is still in flight.
+    class FenceTracker
+    {
+    public:
+        explicit FenceTracker(const Queue &queue);
+
+        FenceTracker(const FenceTracker &other) = delete;
+        FenceTracker(FenceTracker &&other) = delete;
+        FenceTracker & operator=(const FenceTracker &other) = delete;
+        FenceTracker & operator=(FenceTracker &&other) = delete;
+
+        // Returns the serial assigned to this submission.
+        uint64_t submit(std::span<const CommandBuffer> commands);
+        uint64_t submit(std::initializer_list<CommandBuffer> commands);
+
+        [[nodiscard]] bool is_complete(uint64_t serial) const;
+        [[nodiscard]] uint64_t get_completed_serial() const;
+        [[nodiscard]] uint64_t get_last_submitted_serial() const;
+        [[nodiscard]] const Queue & get_queue() const;
+        // Success until a submission finishes with an error, such as after device loss, and then the first
+        // error status. Failed submissions still complete their serial so that nothing waits on them forever.
+        [[nodiscard]] QueueWorkDoneStatus get_status() const;
+
+        // Resumes once the serial completes. A serial that has not been submitted yet would never complete, so
+        // awaiting one resumes straight away with false.
+        [[nodiscard]] FenceAwaitable wait(Executor &executor, uint64_t serial);
+
+    private:
+        friend class FenceAwaitable;
+
+        static void on_work_done(WGPUQueueWorkDoneStatus status, void *user_data);
+
+        Queue m_queue;
+        uint64_t m_last_submitted_serial{0};
+        std::atomic<uint64_t> m_completed_serial{0};
+        std::atomic<QueueWorkDoneStatus> m_status{QueueWorkDoneStatus::Success};
+        std::mutex m_waiters_mutex;
+        std::vector<FenceAwaitable *> m_waiters;
+    };
+
+    // Hands out timestamp writes for named render and compute passes and reports how long each pass took on
+    // the GPU. Every frame records into its own slot of a small ring, and a slot is only read back once its
+    // buffer has mapped, so results arrive a few frames late but the CPU never waits on the GPU. If every
+    // slot is still waiting on a readback when a frame begins, that frame is simply not profiled. The device
+    // must have been created with FeatureName::TimestampQuery.
+    class GpuProfiler
+    {
+    public:
+        struct ScopeTiming
+        {
+            std::string name;
+            uint64_t duration_ns;
+        };
+
+        explicit GpuProfiler(const Device &device, uint32_t max_scopes_per_frame = 32, uint32_t frame_count = 3);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler &other) = delete;
+        GpuProfiler(GpuProfiler &&other) = delete;
+        GpuProfiler & operator=(const GpuProfiler &other) = delete;
+        GpuProfiler & operator=(GpuProfiler &&other) = delete;
+
+        void begin_frame();
+        // Returns std::nullopt when the frame is not being profiled or has run out of scopes, so the result
+        // can be assigned straight to the pass descriptor's timestamp_writes.
+        [[nodiscard]] std::optional<ComputePassTimestampWrites> begin_compute_pass_scope(std::string name);
+        [[nodiscard]] std::optional<RenderPassTimestampWrites> begin_render_pass_scope(std::string name);
+        // Records the query resolve and readback copy. Call once per frame after the last profiled pass.
+        void resolve(const CommandEncoder &encoder);
+        // Starts reading back the resolved frame. Call once per frame after the encoder has been submitted.
+        void end_frame();
+
+        // The timings of the most recent frame whose results have been read back. Returned by value because the
+        // readback may complete on another thread, such as an EventPump's.
+        [[nodiscard]] std::vector<ScopeTiming> get_results() const;
+        [[nodiscard]] uint64_t get_dropped_frame_count() const;
+
+    private:
+        enum class SlotState
+        {
+            Idle,
+            Recording,
+            Resolved,
+            Mapping,
+        };
+
+        struct Slot
+        {
+            QuerySet query_set;
+            Buffer resolve_buffer;
+            Buffer readback_buffer;
+            std::vector<std::string> scope_names;
+            uint32_t query_count{0};
+            SlotState state{SlotState::Idle};
+        };
+
+        [[nodiscard]] std::optional<uint32_t> allocate_scope(std::string &&name);
+        void read_back(Slot &slot);
+
+        // Shared with in-flight readbacks. The mutex guards every slot's state and m_results, which the map
+        // callback writes from whichever thread processes events. The destructor clears alive under it, so a
+        // readback that completes after the profiler is gone is ignored, and one already running finishes first.
+        struct Lifetime
+        {
+            std::mutex mutex;
+            bool alive{true};
+        };
+
+        std::shared_ptr<Lifetime> m_lifetime{std::make_shared<Lifetime>()};
+        std::vector<Slot> m_slots;
+        std::vector<ScopeTiming> m_results;
+        uint32_t m_max_queries;
+        uint64_t m_frame_index{0};
+        size_t m_current_slot{0};
+        bool m_recording{false};
+        uint64_t m_dropped_frame_count{0};
+    };
+
+    // Coroutines
+    namespace detail
+    {
+        class TaskPromiseBase
+        {
+        public:
+            // Hands control straight to whichever coroutine awaited the task, so long chains of awaited tasks
+            // neither recurse nor round-trip through the executor.
+            struct FinalAwaiter
+            {
+                [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+                template<typename P>
+                std::coroutine_handle<> await_suspend(const std::coroutine_handle<P> handle) const noexcept
+                {
+                    const auto continuation = handle.promise().get_continuation();
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                constexpr void await_resume() const noexcept {}
+            };
+
+            [[nodiscard]] constexpr std::suspend_always initial_suspend() const noexcept { return {}; }
+            [[nodiscard]] constexpr FinalAwaiter final_suspend() const noexcept { return {}; }
+            [[noreturn]] void unhandled_exception() const noexcept { std::terminate(); }
+
+            [[nodiscard]] std::coroutine_handle<> get_continuation() const { return m_continuation; }
+            void set_continuation(const std::coroutine_handle<> continuation) { m_continuation = continuation; }
+
+        private:
+            std::coroutine_handle<> m_continuation;
+        };
+
+        template<typename T>
+        class TaskPromise : public TaskPromiseBase
+        {
+        public:
+            [[nodiscard]] Task<T> get_return_object()
+            {
+                return Task<T>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+            }
+
+            void return_value(T value) { m_value.emplace(std::move(value)); }
+            [[nodiscard]] T take_value() { return std::move(*m_value); }
+
+        private:
+            std::optional<T> m_value;
+        };
+
+        template<>
+        class TaskPromise<void> : public TaskPromiseBase
+        {
+        public:
+            [[nodiscard]] Task<void> get_return_object();
+
+            constexpr void return_void() const {}
+            constexpr void take_value() const {}
+        };
+    }
+
+    // A lazily started coroutine. Awaiting a task starts it, and the awaiting coroutine resumes with its result
+    // once it finishes. Top-level tasks are started by Executor::run or Executor::spawn.
+    template<typename T>
+    class Task
+    {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        Task() = default;
+        explicit Task(const std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+        ~Task()
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+            }
+        }
+
+        Task(const Task &other) = delete;
+        Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+        Task & operator=(const Task &other) = delete;
+        Task & operator=(Task &&other) noexcept
+        {
+            std::swap(m_handle, other.m_handle);
+            return *this;
+        }
+
+        [[nodiscard]] bool is_done() const { return !m_handle || m_handle.done(); }
+
+        [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(const std::coroutine_handle<> continuation) noexcept
+        {
+            m_handle.promise().set_continuation(continuation);
+            return m_handle;
+        }
+        T await_resume() { return m_handle.promise().take_value(); }
+
+    private:
+        friend class Executor;
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    // Drives WebGPU event processing and resumes coroutines whose awaited callbacks have fired. Callbacks only
+    // queue their coroutine, so every resumption happens inside poll() on the thread driving the executor.
+    // schedule() is the only member that is safe to call from other threads.
+    class Executor
+    {
+    public:
+        // Creates an executor that leaves event processing to another thread, such as an EventPump. Its poll()
+        // only resumes ready coroutines, and run() sleeps until a callback schedules one instead of spinning.
+        Executor();
+        // Creates an executor that processes the instance's events itself. While nothing is ready it blocks on the
+        // added devices' queues where the backend allows it (wgpu-native), and otherwise sleeps for a timeout that
+        // doubles up to max_idle_wait while it stays idle.
+        explicit Executor(const Instance &instance,
+            std::chrono::microseconds max_idle_wait = std::chrono::microseconds{2000});
+
+        Executor(const Executor &other) = delete;
+        Executor(Executor &&other) = delete;
+        Executor & operator=(const Executor &other) = delete;
+        Executor & operator=(Executor &&other) = delete;
+
+        // Devices added here are ticked on every poll so that their callbacks fire.
+        void add_device(const Device &device);
+        void schedule(std::coroutine_handle<> handle);
+        // Starts a task and keeps it alive until it finishes.
+        void spawn(Task<void> &&task);
+
+        // Processes events and resumes every coroutine that became ready. Returns whether any were resumed.
+        bool poll();
+        // Starts the task and polls until it finishes.
+        template<typename T>
+        T run(Task<T> &&task);
+        // Polls until every spawned task has finished.
+        void run_until_idle();
+
+        [[nodiscard]] size_t get_pending_operation_count() const;
+
+    private:
+        friend class ExecutorAwaitable;
+
+        void wait_for_work();
+
+        Instance m_instance;
+        bool m_processes_events;
+        std::chrono::microseconds m_max_idle_wait{0};
+        std::chrono::microseconds m_idle_wait{0};
+        std::vector<Device> m_devices;
+        std::vector<Task<void>> m_spawned;
+        std::mutex m_mutex;
+        std::condition_variable m_ready_condition;
+        std::vector<std::coroutine_handle<>> m_ready;
+        std::vector<std::coroutine_handle<>> m_resuming;
+        std::atomic<size_t> m_pending_operations{0};
+    };
+
+    // Base for the awaitables that complete from a WebGPU callback. The callback records the result and hands
+    // the coroutine back to the executor instead of resuming it inline.
+    class ExecutorAwaitable
+    {
+    public:
+        explicit ExecutorAwaitable(Executor &executor) : m_executor(executor) {}
+
+        ExecutorAwaitable(const ExecutorAwaitable &other) = delete;
+        ExecutorAwaitable & operator=(const ExecutorAwaitable &other) = delete;
+
+        [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+    protected:
+        void begin(std::coroutine_handle<> handle);
+        void complete();
+
+        Executor &m_executor;
+        std::coroutine_handle<> m_handle;
+    };
+
+    class AdapterRequestAwaitable : public ExecutorAwaitable
+    {
+    public:
+        AdapterRequestAwaitable(Executor &executor, const Instance &instance, const RequestAdapterOptions &options);
+        ~AdapterRequestAwaitable();
+
+        void await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] std::expected<Adapter, std::string> await_resume();
+
+    private:
+        static void on_request_ended(WGPURequestAdapterStatus status, WGPUAdapter adapter, const char *message,
+            void *user_data);
+
+        Instance m_instance;
+        // Copied so the awaitable can be stored before it is awaited. The compatible surface and chained structs
+        // are still borrowed.
+        std::unique_ptr<RequestAdapterOptions> m_options;
+        std::expected<Adapter, std::string> m_result;
+    };
+
+    class BufferMapAwaitable : public ExecutorAwaitable
+    {
+    public:
+        BufferMapAwaitable(Executor &executor, const Buffer &buffer, MapModeFlags mode, size_t offset, size_t size);
+
+        void await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] BufferMapAsyncStatus await_resume() const;
+
+    private:
+        static void on_buffer_mapped(WGPUBufferMapAsyncStatus status, void *user_data);
+
+        Buffer m_buffer;
+        MapModeFlags m_mode;
+        size_t m_offset;
+        size_t m_size;
+        BufferMapAsyncStatus m_status{BufferMapAsyncStatus::Unknown};
+    };
+
+    class DeviceRequestAwaitable : public ExecutorAwaitable
+    {
+    public:
+        DeviceRequestAwaitable(Executor &executor, const Adapter &adapter, const DeviceDescriptor &descriptor);
+        ~DeviceRequestAwaitable();
+
+        void await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] std::expected<Device, std::string> await_resume();
+
+    private:
+        static void on_request_ended(WGPURequestDeviceStatus status, WGPUDevice device, const char *message,
+            void *user_data);
+
+        struct OwnedDescriptor;
+
+        Adapter m_adapter;
+        // Copied, labels included, so the awaitable can be stored before it is awaited. The required limits,
+        // error sink and chained structs are still borrowed.
+        std::unique_ptr<OwnedDescriptor> m_descriptor;
+        // Pooled when the request is made and freed if it fails, otherwise owned by the device.
+        DeviceLostCallback *m_device_lost_callback{nullptr};
+        std::expected<Device, std::string> m_result;
+    };
+
+    class ErrorScopeAwaitable : public ExecutorAwaitable
+    {
+    public:
+        ErrorScopeAwaitable(Executor &executor, const Device &device);
+
+        void await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] DeviceError await_resume();
+
+    private:
+        static void on_error_scope_popped(WGPUErrorType type, const char *message, void *user_data);
+
+        Device m_device;
+        ErrorType m_type{ErrorType::Unknown};
+        std::string m_message;
+    };
+
+    class FenceAwaitable : public ExecutorAwaitable
+    {
+    public:
+        FenceAwaitable(Executor &executor, FenceTracker &tracker, uint64_t serial);
+
+        [[nodiscard]] bool await_ready() const;
+        // Returns false, resuming straight away, if the serial completed while registering.
+        bool await_suspend(std::coroutine_handle<> handle);
+        // Returns false if the serial had not been submitted when the awaitable was made.
+        [[nodiscard]] constexpr bool await_resume() const { return m_submitted; }
+
+    private:
+        friend class FenceTracker;
+
+        FenceTracker &m_tracker;
+        uint64_t m_serial;
+        bool m_submitted;
+    };
+
+    class QueueWorkDoneAwaitable : public ExecutorAwaitable
+    {
+    public:
+        QueueWorkDoneAwaitable(Executor &executor, const Queue &queue);
+
+        void await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] QueueWorkDoneStatus await_resume() const;
+
+    private:
+        static void on_work_done(WGPUQueueWorkDoneStatus status, void *user_data);
+
+        Queue m_queue;
+        QueueWorkDoneStatus m_status{QueueWorkDoneStatus::Unknown};
+    };
+
+    class RenderPipelineCreateAwaitable : public ExecutorAwaitable
+    {
+    public:
+        RenderPipelineCreateAwaitable(Executor &executor, const Device &device,
+            const RenderPipelineDescriptor &descriptor);
+        ~RenderPipelineCreateAwaitable();
+
+        void await_suspend(std::coroutine_handle<> handle);
+        [[nodiscard]] std::expected<RenderPipeline, std::string> await_resume();
+
+    private:
+        struct OwnedDescriptor;
+
+        Device m_device;
+        // Copied, with references on its layout and shader modules, so the awaitable can be stored before it is
+        // awaited. Chained structs are still borrowed.
+        std::unique_ptr<OwnedDescriptor> m_descriptor;
+        std::expected<RenderPipeline, std::string> m_result;
+    };
+
+    // Owns a thread that processes a device's events, so callbacks fire without the application polling. The
+    // thread only polls while work is outstanding, meaning a notify() whose queue work has not finished yet or a
+    // thread blocked in wait(), and otherwise sleeps until notified. While polling on wgpu-native it blocks in
+    // wgpuDevicePoll until submitted work finishes. Dawn cannot block, so there it ticks once every
+    // poll_interval. Callbacks therefore run on the pump thread. Awaitables hand their
+    // coroutine to the executor they were given, which can be an Executor created without an instance. Other
+    // threads can block in wait() until state set by a callback satisfies their predicate. That state should be
+    // atomic, because callbacks write it without holding the pump's lock. On Dawn the device must have been
+    // created with FeatureName::ImplicitDeviceSynchronization to be used from other threads at the same time.
+    class EventPump
+    {
+    public:
+        EventPump(const Instance &instance, const Device &device,
+            std::chrono::nanoseconds poll_interval = std::chrono::milliseconds(1));
+        ~EventPump();
+
+        EventPump(const EventPump &other) = delete;
+        EventPump(EventPump &&other) = delete;
+        EventPump & operator=(const EventPump &other) = delete;
+        EventPump & operator=(EventPump &&other) = delete;
+
+        // Blocks until the predicate holds. It is checked again after each batch of events the pump processes.
+        template<typename Predicate>
+        void wait(Predicate &&predicate);
+        // Returns the predicate's final value.
+        template<typename Predicate>
+        bool wait_for(std::chrono::nanoseconds timeout, Predicate &&predicate);
+        // Wakes the pump and every waiter, and keeps the pump processing events until the queue has finished all
+        // work submitted so far. Call after submitting work or starting an asynchronous operation such as a buffer
+        // map, or after changing state a waiter checks from a thread other than the pump.
+        void notify();
+        // Waits for the work outstanding from earlier notify() calls, so no callback is left pointing at the pump,
+        // then stops and joins the pump thread. Called by the destructor.
+        void stop();
+
+    private:
+        static void on_work_done(WGPUQueueWorkDoneStatus status, void *user_data);
+
+        void run();
+
+        Instance m_instance;
+        Device m_device;
+        Queue m_queue;
+        std::chrono::nanoseconds m_poll_interval;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::condition_variable m_pump_condition;
+        // Work-done callbacks registered by notify() that have not fired yet.
+        size_t m_pending{0};
+        size_t m_waiter_count{0};
+        bool m_pump_woken{false};
+        bool m_stop_requested{false};
+        std::thread m_thread;
+    };
+
+    // A fixed set of worker threads for splitting CPU work such as pipeline compilation or command recording.
+    // parallel_for hands out indices one at a time, so uneven work balances itself, and the calling thread
+    // works alongside the pool until every index is done. One parallel_for runs at a time, and a body must not
+    // start another one.
+    class ThreadPool
+    {
+    public:
+        // Uses one worker fewer than there are hardware threads, since the caller of parallel_for also works.
+        ThreadPool();
+        explicit ThreadPool(size_t worker_count);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &other) = delete;
+        ThreadPool & operator=(const ThreadPool &other) = delete;
+
+        // Calls body(index) for every index in [0, count) and returns once all of them have finished. The body
+        // runs on several threads at once.
+        template<typename Body>
+        void parallel_for(size_t count, Body &&body);
+
+        [[nodiscard]] size_t get_worker_count() const;
+
+    private:
+        void dispatch(size_t count, InlineFunction<void(size_t)> &&body);
+        void run_indices();
+        void run_worker();
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_dispatch_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_work_condition;
+        std::condition_variable m_done_condition;
+        InlineFunction<void(size_t)> *m_body{nullptr};
+        size_t m_count{0};
+        std::atomic<size_t> m_next_index{0};
+        size_t m_busy_worker_count{0};
+        uint64_t m_generation{0};
+        bool m_stop_requested{false};
+    };
+
+    // Splits a frame's command recording across a ThreadPool. record() gives every index its own
+    // CommandEncoder and keeps the finished CommandBuffers in index order, however the work was scheduled, so
+    // submit() sends them in the order the caller defined with a single Queue::submit. Each recording must be
+    // self-contained: passes cannot span indices. On Dawn the device must have been created with
+    // FeatureName::ImplicitDeviceSynchronization, since every worker creates and finishes an encoder.
+    class ParallelRecorder
+    {
+    public:
+        ParallelRecorder(const Device &device, ThreadPool &pool);
+
+        ParallelRecorder(const ParallelRecorder &other) = delete;
+        ParallelRecorder & operator=(const ParallelRecorder &other) = delete;
+
+        // Calls record_commands(index, encoder) for every index in [0, count) across the pool. Any command
+        // buffers recorded earlier and not yet submitted are discarded.
+        template<typename RecordCommands>
+        std::span<const CommandBuffer> record(size_t count, RecordCommands &&record_commands);
+
+        // Submits the recorded command buffers in index order and clears them.
+        void submit(const Queue &queue);
+        // Returns the serial assigned to the submission.
+        uint64_t submit(FenceTracker &fence_tracker);
+
+        [[nodiscard]] std::span<const CommandBuffer> get_command_buffers() const;
+
+    private:
+        Device m_device;
+        ThreadPool &m_pool;
+        std::vector<CommandBuffer> m_command_buffers;
+    };
+
+    namespace detail
+    {
+        // A resource owned by a ResourceRegistry, together with what it needs to create it again.
+        class TrackedRecord
+        {
+        public:
+            virtual ~TrackedRecord() = default;
+
+            virtual void recreate(const Device &device) = 0;
+            [[nodiscard]] virtual const void * get_c_handle() const = 0;
+        };
+    }
+
+    // A handle owned by a ResourceRegistry. The registry replaces the object when it rebuilds, so keep the
+    // Tracked and look the handle up through it rather than holding on to the handle itself.
+    template<typename T>
+    class Tracked
+    {
+    public:
+        Tracked() = default;
+
+        [[nodiscard]] const T & get() const { return *m_handle; }
+        [[nodiscard]] const T & operator*() const { return *m_handle; }
+        [[nodiscard]] const T * operator->() const { return m_handle; }
+        [[nodiscard]] explicit operator bool() const { return m_record != nullptr; }
+
+    private:
+        friend class ResourceRegistry;
+
+        Tracked(std::shared_ptr<detail::TrackedRecord> record, const T *handle)
+            : m_record(std::move(record)), m_handle(handle) {}
+
+        std::shared_ptr<detail::TrackedRecord> m_record;
+        const T *m_handle{nullptr};
+    };
+
+    // Returns the same RenderPipeline for structurally identical descriptors instead of creating another. The key
+    // covers every descriptor field, including vertex buffer layouts, color targets, blend states and constants,
+    // except the label, so a hit comes back under the label its pipeline was first created with. Shader modules
+    // and the pipeline layout are compared by handle and chained structs by address. Each entry keeps a reference
+    // on its modules and layout, so their handles cannot be reused by other objects while they are part of a key.
+    // With a capacity of 0 the cache is unbounded, otherwise the least recently used entry makes room.
+    class RenderPipelineCache
+    {
+    public:
+        explicit RenderPipelineCache(const Device &device, size_t capacity = 0);
+
+        RenderPipelineCache(const RenderPipelineCache &other) = delete;
+        RenderPipelineCache & operator=(const RenderPipelineCache &other) = delete;
+
+        [[nodiscard]] RenderPipeline create_render_pipeline(const RenderPipelineDescriptor &descriptor);
+        void clear();
+
+        [[nodiscard]] size_t get_capacity() const;
+        [[nodiscard]] uint64_t get_hit_count() const;
+        [[nodiscard]] uint64_t get_miss_count() const;
+        [[nodiscard]] size_t get_size() const;
+
+    private:
+        struct Entry
+        {
+            RenderPipeline pipeline;
+            PipelineLayout layout;
+            ShaderModule vertex_module;
+            ShaderModule fragment_module;
+            std::list<const std::string *>::iterator recency;
+        };
+
+        Device m_device;
+        size_t m_capacity;
+        uint64_t m_hit_count{0};
+        uint64_t m_miss_count{0};
+        // Reused between lookups, so a hit does not allocate once it has grown to fit.
+        std::string m_key;
+        std::unordered_map<std::string, Entry> m_entries;
+        // Keys of m_entries, most recently used first.
+        std::list<const std::string *> m_recency;
+    };
+
+    // Creates resources and keeps a copy of each descriptor, so that after a device loss every resource that is
+    // still alive can be created again on a new device with one call to rebuild(). Resources are recreated in
+    // dependency order, and references in the copied descriptors are redirected to the new objects. Descriptors
+    // may therefore only reference resources from this registry: the registry could neither keep anything else
+    // alive nor move it to the new device, so a descriptor that does gets an empty Tracked back. Shader
+    // sources are copied too, but other chained structs are borrowed and must outlive the registry. Buffer and
+    // texture contents are not restored, and buffers created mapped are recreated unmapped. A resource is
+    // dropped from the registry once every Tracked referring to it, directly or through a dependent resource,
+    // has been released.
+    class ResourceRegistry
+    {
+    public:
+        explicit ResourceRegistry(const Device &device);
+
+        ResourceRegistry(const ResourceRegistry &other) = delete;
+        ResourceRegistry & operator=(const ResourceRegistry &other) = delete;
+
+        [[nodiscard]] Tracked<BindGroup> create_bind_group(const BindGroupDescriptor &descriptor);
+        [[nodiscard]] Tracked<BindGroupLayout> create_bind_group_layout(const BindGroupLayoutDescriptor &descriptor);
+        [[nodiscard]] Tracked<Buffer> create_buffer(const BufferDescriptor &descriptor);
+        [[nodiscard]] Tracked<ComputePipeline> create_compute_pipeline(const ComputePipelineDescriptor &descriptor);
+        [[nodiscard]] Tracked<PipelineLayout> create_pipeline_layout(const PipelineLayoutDescriptor &descriptor);
+        [[nodiscard]] Tracked<RenderPipeline> create_render_pipeline(const RenderPipelineDescriptor &descriptor);
+        [[nodiscard]] Tracked<Sampler> create_sampler(const SamplerDescriptor &descriptor);
+        [[nodiscard]] Tracked<ShaderModule> create_shader_module(const ShaderModuleDescriptor &descriptor);
+        [[nodiscard]] Tracked<Texture> create_texture(const TextureDescriptor &descriptor);
+        [[nodiscard]] Tracked<TextureView> create_texture_view(const Tracked<Texture> &texture);
+        [[nodiscard]] Tracked<TextureView> create_texture_view(const Tracked<Texture> &texture,
+            const TextureViewDescriptor &descriptor);
+
+        // Recreates every live resource on the given device, which becomes the registry's device, and returns
+        // how long that took.
+        std::chrono::nanoseconds rebuild(const Device &device);
+
+        [[nodiscard]] const Device & get_device() const;
+        [[nodiscard]] size_t get_resource_count() const;
+
+    private:
+        // Resources are recreated stage by stage, and everything a resource depends on is in an earlier stage.
+        enum Stage : size_t
+        {
+            Independent,  // Bind group layouts, buffers, samplers, shader modules and textures.
+            Intermediate, // Pipeline layouts and texture views.
+            Dependent,    // Bind groups and pipelines.
+            StageCount,
+        };
+
+        template<typename T, typename Record>
+        Tracked<T> track(std::shared_ptr<Record> record, Stage stage);
+        [[nodiscard]] std::shared_ptr<detail::TrackedRecord> find_record(const void *handle);
+        // Returns false if the handle is set but does not belong to this registry.
+        [[nodiscard]] bool find_reference(const void *handle, std::shared_ptr<detail::TrackedRecord> &record);
+        void collect_expired();
+
+        Device m_device;
+        std::array<std::vector<std::weak_ptr<detail::TrackedRecord>>, StageCount> m_stages;
+        std::unordered_map<const void *, std::weak_ptr<detail::TrackedRecord>> m_records_by_handle;
+        size_t m_next_collection_size{64};
+    };
+
+    // Streams uploads through a ring of MapWrite | CopySrc chunks that stay mapped while they are filled, so
+    // the caller writes data straight into staging memory and makes the only CPU copy itself. Each frame, call
+    // write_buffer for every upload, finish before submitting the encoders it recorded into, and recall after
+    // submitting. recall maps the used chunks again, and a chunk is reused once its map callback fires, which
+    // cannot happen before the GPU has finished the copies reading from it. Map callbacks have to be delivered,
+    // through Device::tick or an EventPump, for chunks to come back. An upload larger than chunk_size gets a
+    // chunk of its own, which is released on recall rather than reused. Offsets and sizes must be multiples of 4,
+    // as for CommandEncoder::copy_buffer_to_buffer.
+    class StagingBelt
+    {
+    public:
+        StagingBelt(const Device &device, uint64_t chunk_size);
+
+        StagingBelt(const StagingBelt &other) = delete;
+        StagingBelt & operator=(const StagingBelt &other) = delete;
+
+        // Returns size bytes of mapped staging memory and records a copy from them into destination at offset.
+        // The span has to be filled before finish is called.
+        [[nodiscard]] std::span<std::byte> write_buffer(const CommandEncoder &encoder, const Buffer &destination,
+            uint64_t offset, uint64_t size);
+        void finish();
+        void recall();
+
+        [[nodiscard]] uint64_t get_chunk_size() const;
+
+    private:
+        struct Chunk
+        {
+            Buffer buffer;
+            uint64_t size;
+            uint64_t offset;
+        };
+
+        // Shared with map callbacks, which can fire from another thread or after the belt is gone.
+        struct FreeChunks
+        {
+            std::mutex mutex;
+            std::vector<Chunk> chunks;
+        };
+
+        Chunk & get_chunk(uint64_t size);
+
+        Device m_device;
+        uint64_t m_chunk_size;
+        std::vector<Chunk> m_active_chunks;
+        std::vector<Chunk> m_closed_chunks;
+        std::shared_ptr<FreeChunks> m_free_chunks{std::make_shared<FreeChunks>()};
+    };
+
+    // Recycles transient textures such as render targets, so passes that need one every frame, or reallocate on
+    // resize, stop creating and destroying them. Textures are matched on every descriptor field except the label,
+    // which stays whatever it was when the pool created the texture. A released texture is handed out again once
+    // the FenceTracker serial of its last use has completed, and is dropped after max_idle_frames calls to
+    // end_frame without being reused. Textures acquired from the pool should be released back to it, as the pool
+    // keeps a reference on each acquired texture until then.
+    class TexturePool
+    {
+    public:
+        TexturePool(const Device &device, const FenceTracker &fence_tracker, uint32_t max_idle_frames = 4);
+
+        TexturePool(const TexturePool &other) = delete;
+        TexturePool & operator=(const TexturePool &other) = delete;
+
+        [[nodiscard]] Texture acquire(const TextureDescriptor &descriptor);
+        // Without a serial, the texture is assumed to be last used by the next submission through the tracker.
+        void release(const Texture &texture);
+        void release(const Texture &texture, uint64_t last_use_serial);
+        void end_frame();
+
+        [[nodiscard]] uint64_t get_created_count() const;
+        [[nodiscard]] size_t get_idle_count() const;
+
+    private:
+        struct Key
+        {
+            TextureUsageFlags usage;
+            TextureDimension dimension;
+            uint32_t width;
+            uint32_t height;
+            uint32_t depth_or_array_layers;
+            TextureFormat format;
+            uint32_t mip_level_count;
+            uint32_t sample_count;
+            std::vector<TextureFormat> view_formats;
+
+            bool operator==(const Key &other) const = default;
+        };
+
+        struct KeyHash
+        {
+            size_t operator()(const Key &key) const;
+        };
+
+        struct IdleTexture
+        {
+            Texture texture;
+            uint64_t last_use_serial;
+            uint64_t released_frame;
+        };
+
+        Device m_device;
+        const FenceTracker &m_fence_tracker;
+        uint32_t m_max_idle_frames;
+        uint64_t m_frame{0};
+        uint64_t m_created_count{0};
+        std::unordered_map<Key, std::vector<IdleTexture>, KeyHash> m_idle_textures;
+        struct AcquiredTexture
+        {
+            // Holds a reference, so the address cannot be reused by another texture while it is a key.
+            Texture texture;
+            Key key;
+        };
+
+        // Textures currently handed out, by address, so release can find their bucket.
+        std::unordered_map<const void *, AcquiredTexture> m_acquired_textures;
+    };
+
+    // Packs a frame's dynamic uniform values at min_uniform_buffer_offset_alignment into a CPU-side copy and
+    // uploads them all with a single write_buffer on flush. push returns the dynamic offset to pass to
+    // set_bind_group, or nothing once the buffer is full. Queue writes are ordered with submissions, so each
+    // frame packs from the start of the buffer again after flush.
+    class UniformRing
+    {
+    public:
+        UniformRing(const Device &device, uint32_t size);
+
+        UniformRing(const UniformRing &other) = delete;
+        UniformRing & operator=(const UniformRing &other) = delete;
+
+        template<typename T>
+        [[nodiscard]] std::optional<uint32_t> push(const T &value);
+        [[nodiscard]] std::optional<uint32_t> push_bytes(std::span<const std::byte> data);
+        void flush(const Queue &queue);
+
+        [[nodiscard]] uint32_t get_alignment() const;
+        [[nodiscard]] const Buffer & get_buffer() const;
+        [[nodiscard]] uint32_t get_bytes_used() const;
+        [[nodiscard]] uint32_t get_size() const;
+
+    private:
+        Buffer m_buffer;
+        uint32_t m_alignment;
+        std::vector<std::byte> m_data;
+        uint32_t m_offset{0};
+        uint32_t m_end{0};
+    };
+
+    // Structs
+    struct AdapterProperties
+    {
+        ChainedStructOut *next_in_chain;
+        uint32_t vendor_id;
+        std::string vendor_name;
+        std::string architecture;
+        uint32_t device_id;
+        std::string name;
+        std::string driver_description;
+        AdapterType adapter_type;
+        BackendType backend_type;
+    };
+
+    struct BindGroupDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        BindGroupLayoutRef layout;
+        std::vector<BindGroupEntry> entries;
+    };
+
+    struct BindGroupEntry
+    {
+        const ChainedStruct *next_in_chain;
+        uint32_t binding;
+        BufferRef buffer;
+        uint64_t offset;
+        uint64_t size;
+        SamplerRef sampler;
+        TextureViewRef texture_view;
+    };
+
+    struct BindGroupLayoutDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        std::vector<BindGroupLayoutEntry> entries;
+    };
+
+    struct BufferSlice
+    {
+        BufferRef buffer;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct BufferAllocation
+    {
+        BufferSlice slice;
+        // Identifies the allocation to BufferAllocator::free.
+        uint32_t node;
+    };
+
+    struct BufferAllocatorStatistics
+    {
+        uint64_t capacity;
+        uint64_t allocated_bytes;
+        uint64_t free_bytes;
+        uint64_t largest_free_range;
+        size_t allocation_count;
+        size_t free_range_count;
+        size_t page_count;
+        // 0 when all free space is one range, approaching 1 as it splinters: 1 - largest_free_range / free_bytes.
+        float fragmentation;
+    };
+
+    struct BufferBindingLayout
+    {
+        const ChainedStruct *next_in_chain;
+        BufferBindingType type;
+        bool has_dynamic_offset;
+        uint64_t min_binding_size;
+    };
+
+    struct BufferDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        BufferUsageFlags usage;
+        uint64_t size;
+        bool mapped_at_creation;
+    };
+
+    struct ChainedStruct
+    {
+        const ChainedStruct *next_in_chain;
+        SType s_type;
+    };
+
+    struct ChainedStructOut
+    {
+        ChainedStructOut *next_in_chain;
+        SType s_type;
+    };
+
+    struct Color
+    {
+        double r;
+        double g;
+        double b;
+        double a;
+    };
+
+    struct CommandBufferDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+    };
+
+    struct CommandEncoderDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+    };
+
+    struct ComputePassTimestampWrites
+    {
+        QuerySetRef query_set;
+        uint32_t beginning_of_pass_write_index;
+        uint32_t end_of_pass_write_index;
+    };
+
+    struct ComputePassDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        std::optional<ComputePassTimestampWrites> timestamp_writes;
+    };
+
+    struct ConstantEntry
+    {
+        const ChainedStruct *next_in_chain;
+        std::string key;
+        double value;
+    };
+
+    struct QuerySetDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        QueryType type;
+        uint32_t count;
+    };
+
+    struct QueueDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+    };
+
+    struct DeviceDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        std::vector<FeatureName> required_features;
+        WGPU_NULLABLE const RequiredLimits *required_limits;
+        QueueDescriptor default_queue;
+        // Fires once when the device is lost, including with DeviceLostReason::Destroyed when it is released.
+        DeviceLostCallback device_lost_callback;
+        WGPU_NULLABLE ErrorSink *error_sink;
+    };
+
+    struct DeviceError
+    {
+        ErrorType type;
+        std::string message;
+    };
+
+    struct Extent3D
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth_or_array_layers;
+    };
+
+    struct FragmentState
+    {
+        const ChainedStruct *next_in_chain;
+        ShaderModuleRef module;
+        std::optional<std::string> entry_point;
+        std::vector<ConstantEntry> constants;
+        std::vector<ColorTargetState> targets;
+    };
+
+#ifdef WEBGPU_BACKEND_DAWN
+    struct InstanceFeatures
+    {
+        const ChainedStruct *next_in_chain;
+        bool timed_wait_any_enable;
+        size_t timed_wait_any_max_count;
+    };
+#endif
 
     struct InstanceDescriptor
     {
@@ -1375,8 +2915,15 @@ namespace wgpu
     struct PipelineLayoutDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
-        std::vector<BindGroupLayout> bind_group_layouts;
+        Label label;
+        std::vector<BindGroupLayoutRef> bind_group_layouts;
+    };
+
+    struct PipelineWarmUpResult
+    {
+        std::vector<std::expected<RenderPipeline, std::string>> pipelines;
+        std::vector<std::chrono::nanoseconds> compile_times;
+        std::chrono::nanoseconds total_time;
     };
 
     struct PrimitiveState
@@ -1388,6 +2935,14 @@ namespace wgpu
         CullMode cull_mode;
     };
 
+    struct ProgrammableStageDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        ShaderModuleRef module;
+        std::optional<std::string> entry_point;
+        std::vector<ConstantEntry> constants;
+    };
+
     struct RequestAdapterOptions
     {
         const ChainedStruct *next_in_chain;
@@ -1406,14 +2961,31 @@ namespace wgpu
         Limits limits;
     };
 
+    struct RenderBundleDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+    };
+
+    struct RenderBundleEncoderDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        std::vector<TextureFormat> color_formats;
+        TextureFormat depth_stencil_format;
+        uint32_t sample_count;
+        bool depth_read_only;
+        bool stencil_read_only;
+    };
+
     struct RenderPassColorAttachment
     {
         const ChainedStruct *next_in_chain;
-        std::optional<TextureView> view;
+        TextureViewRef view;
 #ifdef WEBGPU_BACKEND_DAWN
         uint32_t depth_slice = WGPU_DEPTH_SLICE_UNDEFINED;
 #endif
-        std::optional<TextureView> resolve_target;
+        TextureViewRef resolve_target;
         LoadOp load_op;
         StoreOp store_op;
         Color clear_value;
@@ -1421,7 +2993,7 @@ namespace wgpu
 
     struct RenderPassDepthStencilAttachment
     {
-        TextureView view;
+        TextureViewRef view;
         LoadOp depth_load_op;
         StoreOp depth_store_op;
         float depth_clear_value;
@@ -1432,14 +3004,21 @@ namespace wgpu
         bool stencil_read_only;
     };
 
+    struct RenderPassTimestampWrites
+    {
+        QuerySetRef query_set;
+        uint32_t beginning_of_pass_write_index;
+        uint32_t end_of_pass_write_index;
+    };
+
     struct RenderPassDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
+        Label label;
         std::vector<RenderPassColorAttachment> color_attachments;
         std::optional<RenderPassDepthStencilAttachment> depth_stencil_attachment;
-        // TODO: QuerySet
-        // TODO: RenderPassTimestampWrites
+        QuerySetRef occlusion_query_set;
+        std::optional<RenderPassTimestampWrites> timestamp_writes;
     };
 
     struct SamplerBindingLayout
@@ -1451,7 +3030,7 @@ namespace wgpu
     struct SamplerDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
+        Label label;
         AddressMode address_mode_u;
         AddressMode address_mode_v;
         AddressMode address_mode_w;
@@ -1467,7 +3046,7 @@ namespace wgpu
     struct ShaderModuleDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
+        Label label;
     };
 
     struct ShaderModuleSPIRVDescriptor
@@ -1555,7 +3134,7 @@ namespace wgpu
     struct TextureDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
+        Label label;
         TextureUsageFlags usage;
         TextureDimension dimension;
         Extent3D size;
@@ -1568,7 +3147,7 @@ namespace wgpu
     struct TextureViewDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
+        Label label;
         TextureFormat format;
         TextureViewDimension dimension;
         uint32_t base_mip_level;
@@ -1595,12 +3174,20 @@ namespace wgpu
     struct VertexState
     {
         const ChainedStruct *next_in_chain;
-        ShaderModule module;
+        ShaderModuleRef module;
         std::optional<std::string> entry_point;
         std::vector<ConstantEntry> constants;
         std::vector<VertexBufferLayout> buffers;
     };
 
+    struct WaitOptions
+    {
+        std::chrono::nanoseconds timeout{std::chrono::seconds(5)};
+        WaitStrategy strategy{WaitStrategy::Sleep};
+        // How long to sleep between polls when strategy is WaitStrategy::Sleep.
+        std::chrono::nanoseconds sleep_interval{std::chrono::microseconds(100)};
+    };
+
     struct BindGroupLayoutEntry
     {
         const ChainedStruct *next_in_chain;
@@ -1633,6 +3220,14 @@ namespace wgpu
         ColorWriteMaskFlags write_mask;
     };
 
+    struct ComputePipelineDescriptor
+    {
+        const ChainedStruct *next_in_chain;
+        Label label;
+        PipelineLayoutRef layout;
+        ProgrammableStageDescriptor compute;
+    };
+
     struct DepthStencilState
     {
         const ChainedStruct *next_in_chain;
@@ -1653,7 +3248,7 @@ namespace wgpu
 #ifdef WEBGPU_BACKEND_WGPU
         const ChainedStruct *next_in_chain;
 #endif
-        Texture texture;
+        TextureRef texture;
         uint32_t mip_level;
         Origin3D origin;
         TextureAspect aspect;
@@ -1662,8 +3257,8 @@ namespace wgpu
     struct RenderPipelineDescriptor
     {
         const ChainedStruct *next_in_chain;
-        std::string label;
-        std::optional<PipelineLayout> layout;
+        Label label;
+        PipelineLayoutRef layout;
         VertexState vertex;
         PrimitiveState primitive;
         std::optional<DepthStencilState> depth_stencil;
@@ -1675,26 +3270,91 @@ namespace wgpu
     Instance create_instance(const InstanceDescriptor &descriptor);
 
     // Template Definitions
+    template<typename Predicate>
+    void EventPump::wait(Predicate &&predicate)
+    {
+        std::unique_lock lock{m_mutex};
+        ++m_waiter_count;
+        m_pump_condition.notify_one();
+        m_condition.wait(lock, std::forward<Predicate>(predicate));
+        --m_waiter_count;
+    }
+
+    template<typename Predicate>
+    bool EventPump::wait_for(const std::chrono::nanoseconds timeout, Predicate &&predicate)
+    {
+        std::unique_lock lock{m_mutex};
+        ++m_waiter_count;
+        m_pump_condition.notify_one();
+        const auto satisfied = m_condition.wait_for(lock, timeout, std::forward<Predicate>(predicate));
+        --m_waiter_count;
+        return satisfied;
+    }
+
+    template<typename T>
+    T Executor::run(Task<T> &&task)
+    {
+        auto running_task = std::move(task);
+        running_task.m_handle.resume();
+
+        while (!running_task.is_done())
+        {
+            if (!poll())
+            {
+                wait_for_work();
+            }
+        }
+
+        return running_task.m_handle.promise().take_value();
+    }
+
+    template<typename T>
+    [[nodiscard]] std::span<T> FrameArena::allocate(const size_t count)
+    {
+        static_assert(std::is_trivially_destructible_v<T>, "FrameArena never runs destructors.");
+
+        if (count == 0)
+        {
+            return {};
+        }
+
+        auto *data = static_cast<T *>(allocate_bytes(sizeof(T) * count, alignof(T)));
+        std::uninitialized_value_construct_n(data, count);
+        return {data, count};
+    }
+
     template<typename T>
     [[nodiscard]] const T * Buffer::get_const_mapped_range(const size_t offset, const size_t count) const
     {
         return static_cast<const T *>(get_const_mapped_range(offset, count * sizeof(T)));
     }
 
+    template<typename T>
+    [[nodiscard]] T * Buffer::get_mapped_range(const size_t offset, const size_t count) const
+    {
+        return static_cast<T *>(get_mapped_range(offset, count * sizeof(T)));
+    }
+
     template<typename T>
     void Queue::write_buffer(const Buffer &buffer, const uint64_t buffer_offset, const T &data) const
     {
         wgpuQueueWriteBuffer(m_handle, buffer.c_ptr(), buffer_offset, &data, sizeof(T));
     }
 
+    template<typename T, size_t Extent>
+    void Queue::write_buffer(const Buffer &buffer, const uint64_t buffer_offset, const std::span<T, Extent> data) const
+    {
+        wgpuQueueWriteBuffer(m_handle, buffer.c_ptr(), buffer_offset, data.data(), data.size_bytes());
+    }
+
     template<typename T>
     void Queue::write_buffer(const Buffer &buffer, const uint64_t buffer_offset, const std::vector<T> &data) const
     {
-        wgpuQueueWriteBuffer(m_handle, buffer.c_ptr(), buffer_offset, data.data(), data.size() * sizeof(T));
+        write_buffer(buffer, buffer_offset, std::span{data});
     }
 
-    template<typename T>
-    void Queue::write_texture(const ImageCopyTexture &destination, const std::vector<T> &data,
+    template<typename T, size_t Extent>
+    void Queue::write_texture(const ImageCopyTexture &destination, const std::span<T, Extent> data,
         const TextureDataLayout &data_layout, const Extent3D &write_size) const
     {
         const WGPUImageCopyTexture wgpu_destination
@@ -1723,7 +3383,222 @@ namespace wgpu
             .depthOrArrayLayers = write_size.depth_or_array_layers
         };
 
-        wgpuQueueWriteTexture(m_handle, &wgpu_destination, data.data(), data.size(), &wgpu_data_layout,
+        wgpuQueueWriteTexture(m_handle, &wgpu_destination, data.data(), data.size_bytes(), &wgpu_data_layout,
             &wgpu_write_size);
     }
+
+    template<typename T>
+    void Queue::write_texture(const ImageCopyTexture &destination, const std::vector<T> &data,
+        const TextureDataLayout &data_layout, const Extent3D &write_size) const
+    {
+        write_texture(destination, std::span{data}, data_layout, write_size);
+    }
+
+    template<typename RecordCommands>
+    std::span<const CommandBuffer> ParallelRecorder::record(const size_t count, RecordCommands &&record_commands)
+    {
+        // Clearing first releases stale buffers but keeps the capacity, so a steady frame does not reallocate.
+        m_command_buffers.clear();
+        m_command_buffers.resize(count);
+
+        m_pool.parallel_for(count, [&](const size_t index)
+        {
+            const auto encoder = m_device.create_command_encoder(CommandEncoderDescriptor{});
+            record_commands(index, encoder);
+            m_command_buffers[index] = encoder.finish(CommandBufferDescriptor{});
+        });
+
+        return m_command_buffers;
+    }
+
+    template<typename Body>
+    void ThreadPool::parallel_for(const size_t count, Body &&body)
+    {
+        dispatch(count, [&body](const size_t index) { body(index); });
+    }
+
+    template<typename T>
+    [[nodiscard]] std::optional<uint32_t> UniformRing::push(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "Uniform values are uploaded as raw bytes.");
+
+        return push_bytes(std::as_bytes(std::span{&value, 1}));
+    }
+
+    // Inline Definitions
+    inline Task<void> detail::TaskPromise<void>::get_return_object()
+    {
+        return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+    }
+
+    // These are called once or more per draw, so they are defined here to compile down to the bare C call.
+    inline uint64_t Buffer::get_size() const
+    {
+        return wgpuBufferGetSize(m_handle);
+    }
+
+    inline void RenderBundleEncoder::draw(const uint32_t vertex_count, const uint32_t instance_count,
+        const uint32_t first_vertex, const uint32_t first_instance) const
+    {
+        wgpuRenderBundleEncoderDraw(m_handle, vertex_count, instance_count, first_vertex, first_instance);
+    }
+
+    inline void RenderBundleEncoder::draw_indexed(const uint32_t index_count, const uint32_t instance_count,
+        const uint32_t first_index, const int32_t base_vertex, const uint32_t first_instance) const
+    {
+        wgpuRenderBundleEncoderDrawIndexed(m_handle, index_count, instance_count, first_index, base_vertex,
+            first_instance);
+    }
+
+    inline void RenderBundleEncoder::draw_indexed_indirect(const Buffer &indirect_buffer,
+        const uint64_t indirect_offset) const
+    {
+        wgpuRenderBundleEncoderDrawIndexedIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset);
+    }
+
+    inline void RenderBundleEncoder::draw_indirect(const Buffer &indirect_buffer, const uint64_t indirect_offset) const
+    {
+        wgpuRenderBundleEncoderDrawIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset);
+    }
+
+    inline void RenderBundleEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
+        const std::span<const uint32_t> dynamic_offsets) const
+    {
+        wgpuRenderBundleEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(),
+            dynamic_offsets.data());
+    }
+
+    inline void RenderBundleEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
+        const std::initializer_list<uint32_t> dynamic_offsets) const
+    {
+        wgpuRenderBundleEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(),
+            std::data(dynamic_offsets));
+    }
+
+    inline void RenderBundleEncoder::set_index_buffer(const Buffer &buffer, const IndexFormat format,
+        const uint64_t offset, const uint64_t size) const
+    {
+        wgpuRenderBundleEncoderSetIndexBuffer(m_handle, buffer.c_ptr(), static_cast<WGPUIndexFormat>(format), offset,
+            size);
+    }
+
+    inline void RenderBundleEncoder::set_index_buffer(const BufferSlice &slice, const IndexFormat format) const
+    {
+        wgpuRenderBundleEncoderSetIndexBuffer(m_handle, slice.buffer.c_ptr(), static_cast<WGPUIndexFormat>(format),
+            slice.offset, slice.size);
+    }
+
+    inline void RenderBundleEncoder::set_pipeline(const RenderPipeline &pipeline) const
+    {
+        wgpuRenderBundleEncoderSetPipeline(m_handle, pipeline.c_ptr());
+    }
+
+    inline void RenderBundleEncoder::set_vertex_buffer(const uint32_t slot, const Buffer &buffer,
+        const uint64_t offset, const uint64_t size) const
+    {
+        wgpuRenderBundleEncoderSetVertexBuffer(m_handle, slot, buffer.c_ptr(), offset, size);
+    }
+
+    inline void RenderBundleEncoder::set_vertex_buffer(const uint32_t slot, const BufferSlice &slice) const
+    {
+        wgpuRenderBundleEncoderSetVertexBuffer(m_handle, slot, slice.buffer.c_ptr(), slice.offset, slice.size);
+    }
+
+    inline void RenderPassEncoder::draw(const uint32_t vertex_count, const uint32_t instance_count,
+        const uint32_t first_vertex, const uint32_t first_instance) const
+    {
+        wgpuRenderPassEncoderDraw(m_handle, vertex_count, instance_count, first_vertex, first_instance);
+    }
+
+    inline void RenderPassEncoder::draw_indexed(const uint32_t index_count, const uint32_t instance_count,
+        const uint32_t first_index, const int32_t base_vertex, const uint32_t first_instance) const
+    {
+        wgpuRenderPassEncoderDrawIndexed(m_handle, index_count, instance_count, first_index, base_vertex,
+            first_instance);
+    }
+
+    inline void RenderPassEncoder::draw_indexed_indirect(const Buffer &indirect_buffer,
+        const uint64_t indirect_offset) const
+    {
+        wgpuRenderPassEncoderDrawIndexedIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset);
+    }
+
+    inline void RenderPassEncoder::draw_indirect(const Buffer &indirect_buffer, const uint64_t indirect_offset) const
+    {
+        wgpuRenderPassEncoderDrawIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset);
+    }
+
+    inline void RenderPassEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
+        const std::span<const uint32_t> dynamic_offsets) const
+    {
+        wgpuRenderPassEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(),
+            dynamic_offsets.data());
+    }
+
+    inline void RenderPassEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
+        const std::initializer_list<uint32_t> dynamic_offsets) const
+    {
+        wgpuRenderPassEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(),
+            std::data(dynamic_offsets));
+    }
+
+    inline void RenderPassEncoder::set_index_buffer(const Buffer &buffer, const IndexFormat format,
+        const uint64_t offset, const uint64_t size) const
+    {
+        wgpuRenderPassEncoderSetIndexBuffer(m_handle, buffer.c_ptr(), static_cast<WGPUIndexFormat>(format), offset,
+            size);
+    }
+
+    inline void RenderPassEncoder::set_index_buffer(const BufferSlice &slice, const IndexFormat format) const
+    {
+        wgpuRenderPassEncoderSetIndexBuffer(m_handle, slice.buffer.c_ptr(), static_cast<WGPUIndexFormat>(format),
+            slice.offset, slice.size);
+    }
+
+    inline void RenderPassEncoder::set_pipeline(const RenderPipeline &pipeline) const
+    {
+        wgpuRenderPassEncoderSetPipeline(m_handle, pipeline.c_ptr());
+    }
+
+    inline void RenderPassEncoder::set_vertex_buffer(const uint32_t slot, const Buffer &buffer, const uint64_t offset,
+        const uint64_t size) const
+    {
+        wgpuRenderPassEncoderSetVertexBuffer(m_handle, slot, buffer.c_ptr(), offset, size);
+    }
+
+    inline void RenderPassEncoder::set_vertex_buffer(const uint32_t slot, const BufferSlice &slice) const
+    {
+        wgpuRenderPassEncoderSetVertexBuffer(m_handle, slot, slice.buffer.c_ptr(), slice.offset, slice.size);
+    }
+
+    inline void ComputePassEncoder::dispatch_workgroups(const uint32_t workgroup_count_x,
+        const uint32_t workgroup_count_y, const uint32_t workgroup_count_z) const
+    {
+        wgpuComputePassEncoderDispatchWorkgroups(m_handle, workgroup_count_x, workgroup_count_y, workgroup_count_z);
+    }
+
+    inline void ComputePassEncoder::dispatch_workgroups_indirect(const Buffer &indirect_buffer,
+        const uint64_t indirect_offset) const
+    {
+        wgpuComputePassEncoderDispatchWorkgroupsIndirect(m_handle, indirect_buffer.c_ptr(), indirect_offset);
+    }
+
+    inline void ComputePassEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
+        const std::span<const uint32_t> dynamic_offsets) const
+    {
+        wgpuComputePassEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(),
+            dynamic_offsets.data());
+    }
+
+    inline void ComputePassEncoder::set_bind_group(const uint32_t group_index, const BindGroup &group,
+        const std::initializer_list<uint32_t> dynamic_offsets) const
+    {
+        wgpuComputePassEncoderSetBindGroup(m_handle, group_index, group.c_ptr(), dynamic_offsets.size(),
+            std::data(dynamic_offsets));
+    }
+
+    inline void ComputePassEncoder::set_pipeline(const ComputePipeline &pipeline) const
+    {
+        wgpuComputePassEncoderSetPipeline(m_handle, pipeline.c_ptr());
+    }
 }
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// A minimal assertion for the test executables. It reports the failing expression and keeps going, so one
+// run shows every failure. Each test's main returns check_result().
+inline int g_check_failures = 0;
+
+#define CHECK(expression)                                                                                         \
+    do                                                                                                            \
+    {                                                                                                             \
+        if (!(expression))                                                                                        \
+        {                                                                                                         \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #expression ") failed\n";                      \
+            ++g_check_failures;                                                                                   \
+        }                                                                                                         \
+    } while (false)
+
+inline int check_result()
+{
+    return g_check_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
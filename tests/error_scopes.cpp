@@ -0,0 +1,171 @@
+#include "check.hpp"
+
+#include <wgpu.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+
+namespace
+{
+    // Returned when there is no adapter to run on, which CTest reports as a skipped test.
+    constexpr int skipped = 77;
+
+    constexpr auto shader_source = "@vertex\n"
+                                   "fn vs_main(@builtin(vertex_index) index: u32) -> @builtin(position) vec4f {\n"
+                                   "    return vec4f(f32(index), 0.0, 0.0, 1.0);\n"
+                                   "}\n"
+                                   "\n"
+                                   "@fragment\n"
+                                   "fn fs_main() -> @location(0) vec4f {\n"
+                                   "    return vec4f(1.0);\n"
+                                   "}\n";
+
+    wgpu::RenderPipelineDescriptor make_pipeline_descriptor(const wgpu::ShaderModule &module,
+        const char *vertex_entry_point)
+    {
+        return wgpu::RenderPipelineDescriptor
+        {
+            .label = "Error Scope Test Pipeline",
+            .vertex = wgpu::VertexState
+            {
+                .module = module,
+                .entry_point = vertex_entry_point,
+            },
+            .primitive = wgpu::PrimitiveState
+            {
+                .topology = wgpu::PrimitiveTopology::TriangleList,
+                .strip_index_format = wgpu::IndexFormat::Undefined,
+                .front_face = wgpu::FrontFace::CCW,
+                .cull_mode = wgpu::CullMode::None,
+            },
+            .multisample = wgpu::MultisampleState
+            {
+                .count = 1,
+                .mask = ~0u,
+                .alpha_to_coverage_enabled = false,
+            },
+            .fragment = wgpu::FragmentState
+            {
+                .module = module,
+                .entry_point = "fs_main",
+                .targets =
+                {
+                    {
+                        .format = wgpu::TextureFormat::RGBA8Unorm,
+                        .write_mask = wgpu::ColorWriteMaskFlags::All,
+                    },
+                },
+            },
+        };
+    }
+
+    // Pipelines are created asynchronously, half of them invalid, while the application pushes and pops scopes
+    // of its own. Every pipeline has to get its own result, and no pipeline error may end up in an application
+    // scope, which stays empty.
+    void test_async_creation_beside_application_scopes(const wgpu::Instance &instance, const wgpu::Device &device,
+        const wgpu::ShaderModule &module)
+    {
+        constexpr int pipeline_count = 64;
+
+        const auto valid = make_pipeline_descriptor(module, "vs_main");
+        const auto invalid = make_pipeline_descriptor(module, "missing_entry_point");
+
+        std::atomic<int> pipelines_done{0};
+        std::atomic<int> pipelines_misreported{0};
+        std::atomic<int> scopes_done{0};
+        std::atomic<int> scopes_misreported{0};
+
+        for (int i = 0; i < pipeline_count; ++i)
+        {
+            const bool expect_valid = i % 2 == 0;
+            device.create_render_pipeline_async(expect_valid ? valid : invalid,
+                [&pipelines_done, &pipelines_misreported, expect_valid](const wgpu::CreatePipelineAsyncStatus status,
+                    const wgpu::RenderPipeline &, const std::string &)
+                {
+                    if ((status == wgpu::CreatePipelineAsyncStatus::Success) != expect_valid)
+                    {
+                        pipelines_misreported.fetch_add(1);
+                    }
+                    pipelines_done.fetch_add(1);
+                });
+
+            device.push_error_scope(wgpu::ErrorFilter::Validation);
+            device.pop_error_scope([&scopes_done, &scopes_misreported](const wgpu::ErrorType type, const std::string &)
+            {
+                if (type != wgpu::ErrorType::NoError)
+                {
+                    scopes_misreported.fetch_add(1);
+                }
+                scopes_done.fetch_add(1);
+            });
+        }
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{30};
+        while ((pipelines_done.load() < pipeline_count || scopes_done.load() < pipeline_count)
+            && std::chrono::steady_clock::now() < deadline)
+        {
+            instance.process_events();
+            device.tick();
+        }
+
+        CHECK(pipelines_done.load() == pipeline_count);
+        CHECK(pipelines_misreported.load() == 0);
+        CHECK(scopes_done.load() == pipeline_count);
+        CHECK(scopes_misreported.load() == 0);
+    }
+
+    // A warm-up reports a descriptor that fails validation as an error on both backends, and does not let it
+    // affect the other descriptors.
+    void test_warm_up_reports_invalid_descriptors(const wgpu::Device &device, const wgpu::ShaderModule &module)
+    {
+        const wgpu::RenderPipelineDescriptor descriptors[]
+        {
+            make_pipeline_descriptor(module, "vs_main"),
+            make_pipeline_descriptor(module, "missing_entry_point"),
+            make_pipeline_descriptor(module, "vs_main"),
+        };
+
+        wgpu::ThreadPool pool;
+        const auto result = device.warm_up_render_pipelines(descriptors, pool);
+        CHECK(result.pipelines.size() == 3);
+        CHECK(result.pipelines[0].has_value());
+        CHECK(!result.pipelines[1].has_value());
+        CHECK(result.pipelines[2].has_value());
+    }
+}
+
+int main()
+{
+    const auto instance = wgpu::create_instance({});
+    const auto adapter = instance.create_adapter({});
+    if (!adapter)
+    {
+        std::cerr << "No adapter: " << adapter.error() << '\n';
+        return skipped;
+    }
+    const auto device = adapter->create_device({});
+    if (!device)
+    {
+        std::cerr << "No device: " << device.error() << '\n';
+        return skipped;
+    }
+
+    constexpr wgpu::ShaderModuleWGSLDescriptor wgsl_descriptor
+    {
+        .chain = wgpu::ChainedStruct
+        {
+            .next_in_chain = nullptr,
+            .s_type = wgpu::SType::ShaderModuleWGSLDescriptor,
+        },
+        .code = shader_source,
+    };
+    const auto module = device->create_shader_module({
+        .next_in_chain = &wgsl_descriptor.chain,
+        .label = "Error Scope Test Shader",
+    });
+
+    test_async_creation_beside_application_scopes(instance, *device, module);
+    test_warm_up_reports_invalid_descriptors(*device, module);
+    return check_result();
+}
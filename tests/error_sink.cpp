@@ -0,0 +1,109 @@
+#include "check.hpp"
+
+#include <wgpu.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    void test_capacity_rounds_up()
+    {
+        CHECK(wgpu::ErrorSink{1}.get_capacity() == 2);
+        CHECK(wgpu::ErrorSink{5}.get_capacity() == 8);
+        CHECK(wgpu::ErrorSink{64}.get_capacity() == 64);
+    }
+
+    void test_pops_in_order()
+    {
+        wgpu::ErrorSink sink{4};
+        CHECK(!sink.try_pop());
+
+        CHECK(sink.push(wgpu::ErrorType::Validation, "first"));
+        CHECK(sink.push(wgpu::ErrorType::OutOfMemory, "second"));
+
+        const auto first = sink.try_pop();
+        CHECK(first && first->type == wgpu::ErrorType::Validation && first->message == "first");
+        const auto second = sink.try_pop();
+        CHECK(second && second->type == wgpu::ErrorType::OutOfMemory && second->message == "second");
+        CHECK(!sink.try_pop());
+    }
+
+    void test_drops_when_full()
+    {
+        wgpu::ErrorSink sink{2};
+        CHECK(sink.push(wgpu::ErrorType::Internal, "a"));
+        CHECK(sink.push(wgpu::ErrorType::Internal, "b"));
+        CHECK(!sink.push(wgpu::ErrorType::Internal, "c"));
+        CHECK(sink.get_dropped_count() == 1);
+
+        // Popping frees a cell for the next lap around the ring.
+        CHECK(sink.try_pop()->message == "a");
+        CHECK(sink.push(wgpu::ErrorType::Internal, "d"));
+        CHECK(sink.try_pop()->message == "b");
+        CHECK(sink.try_pop()->message == "d");
+        CHECK(sink.get_dropped_count() == 1);
+    }
+
+    void test_truncates_long_messages()
+    {
+        wgpu::ErrorSink sink;
+        const std::string message(wgpu::ErrorSink::max_message_length + 10, 'x');
+        CHECK(sink.push(wgpu::ErrorType::Validation, message));
+        CHECK(sink.try_pop()->message == message.substr(0, wgpu::ErrorSink::max_message_length));
+    }
+
+    void test_concurrent_producers()
+    {
+        constexpr size_t producer_count = 4;
+        constexpr size_t pushes_per_producer = 10'000;
+
+        wgpu::ErrorSink sink{16};
+        std::vector<std::thread> producers;
+        for (size_t i = 0; i < producer_count; ++i)
+        {
+            producers.emplace_back([&sink]
+            {
+                for (size_t j = 0; j < pushes_per_producer; ++j)
+                {
+                    (void) sink.push(wgpu::ErrorType::Validation, "error");
+                }
+            });
+        }
+
+        // Every push is either popped exactly once or counted as dropped.
+        uint64_t popped_count = 0;
+        bool intact = true;
+        const auto drain = [&]
+        {
+            while (const auto error = sink.try_pop())
+            {
+                intact = intact && error->message == "error";
+                ++popped_count;
+            }
+        };
+        while (popped_count + sink.get_dropped_count() < producer_count * pushes_per_producer)
+        {
+            drain();
+        }
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+        drain();
+
+        CHECK(intact);
+        CHECK(popped_count + sink.get_dropped_count() == producer_count * pushes_per_producer);
+    }
+}
+
+int main()
+{
+    test_capacity_rounds_up();
+    test_pops_in_order();
+    test_drops_when_full();
+    test_truncates_long_messages();
+    test_concurrent_producers();
+    return check_result();
+}
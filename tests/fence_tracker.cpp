@@ -0,0 +1,45 @@
+#include "check.hpp"
+
+#include <wgpu.hpp>
+
+namespace
+{
+    wgpu::Task<bool> await_serial(wgpu::Executor &executor, wgpu::FenceTracker &tracker, const uint64_t serial)
+    {
+        co_return co_await tracker.wait(executor, serial);
+    }
+
+    void test_nothing_submitted()
+    {
+        const wgpu::FenceTracker tracker{wgpu::Queue{}};
+        CHECK(tracker.get_last_submitted_serial() == 0);
+        CHECK(tracker.get_completed_serial() == 0);
+        CHECK(tracker.is_complete(0));
+        CHECK(!tracker.is_complete(1));
+        CHECK(tracker.get_status() == wgpu::QueueWorkDoneStatus::Success);
+    }
+
+    void test_wait_on_completed_serial()
+    {
+        wgpu::Executor executor;
+        wgpu::FenceTracker tracker{wgpu::Queue{}};
+        CHECK(executor.run(await_serial(executor, tracker, 0)));
+    }
+
+    void test_wait_on_unsubmitted_serial()
+    {
+        // Would suspend forever if the awaitable registered itself as a waiter.
+        wgpu::Executor executor;
+        wgpu::FenceTracker tracker{wgpu::Queue{}};
+        CHECK(!executor.run(await_serial(executor, tracker, 1)));
+        CHECK(executor.get_pending_operation_count() == 0);
+    }
+}
+
+int main()
+{
+    test_nothing_submitted();
+    test_wait_on_completed_serial();
+    test_wait_on_unsubmitted_serial();
+    return check_result();
+}
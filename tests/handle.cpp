@@ -0,0 +1,156 @@
+#include "check.hpp"
+
+#include <wgpu.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace
+{
+    // Stands in for a WebGPU object so the reference counting can be observed without a device.
+    struct FakeObject
+    {
+        int references = 1;
+    };
+
+    using FakeHandle = FakeObject *;
+
+    struct FakeTraits
+    {
+        static void add_ref(const FakeHandle handle) { ++handle->references; }
+        static void release(const FakeHandle handle) { --handle->references; }
+    };
+
+    using Fake = wgpu::Handle<FakeHandle, FakeTraits>;
+    using FakeRef = wgpu::HandleRef<Fake, FakeHandle>;
+
+    static_assert(std::is_nothrow_move_constructible_v<Fake>);
+    static_assert(std::is_nothrow_move_assignable_v<Fake>);
+    static_assert(sizeof(wgpu::Buffer) == sizeof(WGPUBuffer));
+    static_assert(sizeof(wgpu::BufferRef) == sizeof(WGPUBuffer));
+    static_assert(std::is_trivially_copyable_v<wgpu::BufferRef>);
+
+    void test_default_is_null()
+    {
+        const Fake handle;
+        CHECK(handle.c_ptr() == nullptr);
+    }
+
+    void test_adopt_and_release()
+    {
+        FakeObject object;
+        {
+            const Fake handle{&object};
+            CHECK(handle.c_ptr() == &object);
+            CHECK(object.references == 1);
+        }
+        CHECK(object.references == 0);
+    }
+
+    void test_copy_construct()
+    {
+        FakeObject object;
+        {
+            const Fake handle{&object};
+            {
+                const Fake copy{handle};
+                CHECK(copy.c_ptr() == &object);
+                CHECK(object.references == 2);
+            }
+            CHECK(object.references == 1);
+        }
+        CHECK(object.references == 0);
+    }
+
+    void test_copy_assign()
+    {
+        FakeObject first;
+        FakeObject second;
+        {
+            Fake handle{&first};
+            const Fake other{&second};
+
+            handle = other;
+            CHECK(handle.c_ptr() == &second);
+            CHECK(first.references == 0);
+            CHECK(second.references == 2);
+
+            const Fake &self = handle;
+            handle = self;
+            CHECK(handle.c_ptr() == &second);
+            CHECK(second.references == 2);
+        }
+        CHECK(second.references == 0);
+    }
+
+    void test_copy_assign_from_null()
+    {
+        FakeObject object;
+        Fake handle{&object};
+        handle = Fake{};
+        CHECK(handle.c_ptr() == nullptr);
+        CHECK(object.references == 0);
+    }
+
+    void test_move_construct()
+    {
+        FakeObject object;
+        {
+            Fake handle{&object};
+            const Fake moved{std::move(handle)};
+            CHECK(handle.c_ptr() == nullptr);
+            CHECK(moved.c_ptr() == &object);
+            CHECK(object.references == 1);
+        }
+        CHECK(object.references == 0);
+    }
+
+    void test_move_assign()
+    {
+        FakeObject first;
+        FakeObject second;
+        {
+            Fake handle{&first};
+            {
+                Fake other{&second};
+                handle = std::move(other);
+                CHECK(handle.c_ptr() == &second);
+                CHECK(first.references == 1);
+                CHECK(second.references == 1);
+            }
+            // The moved-from handle took the old object with it and released it when it went out of scope.
+            CHECK(first.references == 0);
+        }
+        CHECK(second.references == 0);
+    }
+
+    void test_ref_does_not_touch_references()
+    {
+        FakeObject object;
+        {
+            const Fake handle{&object};
+            const FakeRef ref{handle};
+            const FakeRef copy = ref;
+            CHECK(copy.c_ptr() == &object);
+            CHECK(static_cast<bool>(copy));
+            CHECK(object.references == 1);
+        }
+        CHECK(object.references == 0);
+
+        const FakeRef empty = std::nullopt;
+        CHECK(!empty);
+    }
+}
+
+int main()
+{
+    test_default_is_null();
+    test_adopt_and_release();
+    test_copy_construct();
+    test_copy_assign();
+    test_copy_assign_from_null();
+    test_move_construct();
+    test_move_assign();
+    test_ref_does_not_touch_references();
+    return check_result();
+}
@@ -0,0 +1,55 @@
+#include "check.hpp"
+
+#include <wgpu.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace
+{
+    void test_every_index_runs_once(wgpu::ThreadPool &pool, const size_t count)
+    {
+        std::vector<std::atomic<int>> calls(count);
+        pool.parallel_for(count, [&calls](const size_t index) { calls[index].fetch_add(1); });
+
+        for (const auto &call : calls)
+        {
+            CHECK(call.load() == 1);
+        }
+    }
+
+    void test_without_workers()
+    {
+        wgpu::ThreadPool pool{0};
+        CHECK(pool.get_worker_count() == 0);
+        test_every_index_runs_once(pool, 100);
+    }
+
+    void test_with_workers()
+    {
+        wgpu::ThreadPool pool{4};
+        CHECK(pool.get_worker_count() == 4);
+        test_every_index_runs_once(pool, 0);
+        test_every_index_runs_once(pool, 1);
+        test_every_index_runs_once(pool, 10'000);
+    }
+
+    void test_repeated_dispatches()
+    {
+        wgpu::ThreadPool pool{3};
+        std::atomic<size_t> sum{0};
+        for (size_t round = 0; round < 100; ++round)
+        {
+            pool.parallel_for(64, [&sum](const size_t index) { sum.fetch_add(index); });
+        }
+        CHECK(sum.load() == 100 * (63 * 64 / 2));
+    }
+}
+
+int main()
+{
+    test_without_workers();
+    test_with_workers();
+    test_repeated_dispatches();
+    return check_result();
+}